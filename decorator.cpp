@@ -1,4 +1,22 @@
 #include <iostream>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <array>
+#include <typeinfo>
+#include <unordered_map>
+#include <string_view>
 using namespace std;
 
 /*
@@ -25,6 +43,25 @@ public:
     virtual void description() = 0; // description of pizza
     virtual int price() = 0;        // price of pizza
     virtual ~BasePizza() {}
+
+    // Pizzas and toppings created with new are counted for the arena benchmark (see 7️⃣)
+    inline static atomic<long long> heapLayers{0};
+    static void* operator new(size_t size) {
+        heapLayers.fetch_add(1, memory_order_relaxed);
+        return ::operator new(size);
+    }
+    static void operator delete(void* p) { ::operator delete(p); }
+
+    // Used by SealedPizza to walk a decorator chain:
+    // the wrapped pizza (nullptr for a base pizza) and this layer's own share of price()
+    virtual BasePizza* wrapped() { return nullptr; }
+    virtual int layerCost() { return price(); }
+
+    // Used by render(): the text this layer adds to the description
+    // (nullptr = this layer renders itself: it must then override render())
+    virtual const char* label() { return nullptr; }
+    // Writes the full description into buf without touching cout (see 9️⃣)
+    virtual size_t render(char* buf, size_t cap);
 };
 
 // =========================
@@ -35,8 +72,9 @@ class Margerita : public BasePizza {
 public:
     Margerita(int cost) { this->cost = cost; }
 
+    const char* label() override { return "This is a Margerita Pizza"; }
     void description() override {
-        cout << "This is a Margerita Pizza";
+        cout << label();
     }
 
     int price() override { return cost; }
@@ -47,8 +85,9 @@ class Farmhouse : public BasePizza {
 public:
     Farmhouse(int cost) { this->cost = cost; }
 
+    const char* label() override { return "This is a Farmhouse Pizza"; }
     void description() override {
-        cout << "This is a Farmhouse Pizza";
+        cout << label();
     }
 
     int price() override { return cost; }
@@ -67,6 +106,13 @@ public:
     // By default, decorator delegates to the wrapped pizza
     void description() override { pizza->description(); }
     int price() override { return pizza->price(); }
+
+    BasePizza* wrapped() override { return pizza; }
+    // Derived from price(), so a topping that only overrides price() still seals correctly;
+    // toppings that know their cost override this to avoid walking the chain twice.
+    int layerCost() override { return price() - pizza->price(); }
+    // No label() override: a topping that only overrides description() must
+    // not render as if it added nothing, so render() throws for it instead.
 };
 
 // =========================
@@ -79,12 +125,14 @@ class CheeseTopping : public PizzaDecorator {
 public:
     CheeseTopping(BasePizza* pizza, int cost) : PizzaDecorator(pizza) { this->cost = cost; }
 
+    const char* label() override { return " with added Cheese Topping"; }
     void description() override {
         pizza->description(); // first call wrapped pizza description
-        cout << " with added Cheese Topping"; // then add extra behavior
+        cout << label(); // then add extra behavior
     }
 
     int price() override { return pizza->price() + cost; }
+    int layerCost() override { return cost; }
 };
 
 // Paneer Topping Decorator
@@ -93,35 +141,768 @@ class PaneerTopping : public PizzaDecorator {
 public:
     PaneerTopping(BasePizza* pizza, int cost) : PizzaDecorator(pizza) { this->cost = cost; }
 
+    const char* label() override { return " with added Paneer Topping"; }
     void description() override {
         pizza->description(); // first call wrapped pizza description
-        cout << " with added Paneer Topping"; // then add extra behavior
+        cout << label(); // then add extra behavior
     }
 
     int price() override { return pizza->price() + cost; }
+    int layerCost() override { return cost; }
 };
 
 // =========================
-// 5️⃣ Usage / Test
+// 5️⃣ Sealed Pizza
 // =========================
-int main() {
-    // Create base pizza
+/*
+Every price() on a decorator chain walks all N layers (N virtual calls + N pointer chases).
+Once an order is final, seal() flattens the chain into one contiguous array of
+layer costs (base pizza first) and caches the total, so price() becomes O(1).
+
+- The original chain is only borrowed: it must outlive the SealedPizza (description() still uses it)
+- A sealed pizza is itself a BasePizza, so it can be wrapped again by more toppings
+*/
+class SealedPizza : public BasePizza {
+    BasePizza* original;
+    vector<int> layers; // base pizza cost first, then each topping in the order it was added
+    int total;
+
+public:
+    SealedPizza(BasePizza* pizza) {
+        original = pizza;
+        for (BasePizza* layer = pizza; layer != nullptr; layer = layer->wrapped()) {
+            layers.push_back(layer->layerCost());
+        }
+        // the walk goes outermost -> base, store base first
+        for (size_t i = 0, j = layers.size() - 1; i < j; i++, j--) swap(layers[i], layers[j]);
+        total = 0;
+        for (int cost : layers) total += cost;
+    }
+
+    void description() override { original->description(); }
+    size_t render(char* buf, size_t cap) override { return original->render(buf, cap); }
+    int price() override { return total; }
+
+    size_t layerCount() const { return layers.size(); }
+    int layerCostAt(size_t i) const { return layers[i]; }
+};
+
+SealedPizza* seal(BasePizza* pizza) { return new SealedPizza(pizza); }
+
+// =========================
+// 6️⃣ Compile-time Decorators
+// =========================
+/*
+When the toppings are known at compile time there is no need for a heap-allocated chain.
+Decorated<Margerita, Cheese, Paneer> stores the base pizza inline and describes each topping
+as a type with a constexpr cost, so:
+- price() = one non-virtual call to the base + a constant folded from the toppings
+- description() is a straight sequence of inlined writes
+- no allocation per layer, the whole pizza is sizeof(Margerita) + a vptr
+
+Decorated is still a BasePizza, so it mixes freely with the runtime decorators
+(e.g. new CheeseTopping(&decorated, 10)). Calls through a Decorated<...>& are devirtualized
+because the class is final; through a BasePizza* they cost one virtual call in total.
+
+With g++ -O2, price() on a Decorated<Margerita, Cheese, Paneer>& compiles to a load of the
+base cost plus an immediate add of 30; the dynamic chain is three dependent indirect calls.
+*/
+
+// Compile-time toppings (costs match the runtime toppings used in main)
+struct Cheese {
+    static constexpr int cost = 10;
+    static constexpr const char* label = " with added Cheese Topping";
+    static void describe() { cout << label; }
+};
+
+struct Paneer {
+    static constexpr int cost = 20;
+    static constexpr const char* label = " with added Paneer Topping";
+    static void describe() { cout << label; }
+};
+
+template <typename Base, typename... Toppings>
+class Decorated final : public BasePizza {
+    Base base; // stored inline, called non-virtually
+
+public:
+    static constexpr int toppingCost = (0 + ... + Toppings::cost);
+
+    // Constrained so it never competes with the copy and move constructors
+    template <typename... Args>
+        requires is_constructible_v<Base, Args...>
+    Decorated(Args&&... args) : base(std::forward<Args>(args)...) {}
+
+    void description() override {
+        base.Base::description();
+        (Toppings::describe(), ...);
+    }
+
+    int price() override { return base.Base::price() + toppingCost; }
+
+    size_t render(char* buf, size_t cap) override;
+};
+
+// =========================
+// 7️⃣ Ownership & Arena Allocation
+// =========================
+/*
+A PizzaDecorator does not own the pizza it wraps, so `delete outermost` frees only one layer.
+Two ways to clean up correctly:
+
+1. deleteChain(pizza): walks wrapped() and deletes every layer (for chains built with new)
+2. OrderArena: every layer of an order is placement-new'ed into one bump-allocated region;
+   release() runs the destructors (newest first) and rewinds the region in one go.
+   Reusing the arena for the next order means no heap allocation at all in steady state.
+
+Chains built in an arena must not be deleted individually, and must not outlive release().
+*/
+void deleteChain(BasePizza* pizza) {
+    while (pizza != nullptr) {
+        BasePizza* inner = pizza->wrapped();
+        delete pizza;
+        pizza = inner;
+    }
+}
+
+class OrderArena {
+    struct Block {
+        Block* next;
+        size_t size;
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+    struct Cleanup {
+        void (*destroy)(void*);
+        void* object;
+        Cleanup* next;
+    };
+    Block* first;      // kept across release() so the next order reuses it
+    Block* current;
+    size_t used;       // bytes used in current
+    Cleanup* cleanups; // newest first
+
+    static Block* newBlock(size_t size) {
+        blocksAllocated.fetch_add(1, memory_order_relaxed);
+        Block* b = static_cast<Block*>(::operator new(sizeof(Block) + size));
+        b->next = nullptr;
+        b->size = size;
+        return b;
+    }
+
+    // Bump-allocates from the current block, moving to the next block when it is full.
+    void* allocate(size_t size, size_t align) {
+        while (true) {
+            uintptr_t start = reinterpret_cast<uintptr_t>(current->data());
+            uintptr_t aligned = (start + used + align - 1) & ~(uintptr_t)(align - 1);
+            if (aligned + size <= start + current->size) {
+                used = aligned + size - start;
+                return reinterpret_cast<void*>(aligned);
+            }
+            // reuse a block left over from an earlier order if it is big enough, else chain a new one
+            if (current->next == nullptr || current->next->size < size + align) {
+                Block* extra = newBlock(max(current->size * 2, size + align));
+                extra->next = current->next;
+                current->next = extra;
+            }
+            current = current->next;
+            used = 0;
+        }
+    }
+
+public:
+    inline static atomic<long long> blocksAllocated{0}; // heap allocations made by all arenas
+
+    OrderArena(size_t bytes = 1024) {
+        first = current = newBlock(bytes);
+        used = 0;
+        cleanups = nullptr;
+    }
+    OrderArena(const OrderArena&) = delete;
+    OrderArena& operator=(const OrderArena&) = delete;
+
+    ~OrderArena() {
+        release();
+        while (first != nullptr) {
+            Block* next = first->next;
+            ::operator delete(first);
+            first = next;
+        }
+    }
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        T* object = ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if (!is_trivially_destructible<T>::value) {
+            Cleanup* c = ::new (allocate(sizeof(Cleanup), alignof(Cleanup))) Cleanup;
+            c->destroy = [](void* p) { static_cast<T*>(p)->~T(); };
+            c->object = object;
+            c->next = cleanups;
+            cleanups = c;
+        }
+        return object;
+    }
+
+    // Ends the order: destroys everything made since the last release, keeps the memory.
+    void release() {
+        while (cleanups != nullptr) {
+            Cleanup* next = cleanups->next;
+            cleanups->destroy(cleanups->object);
+            cleanups = next;
+        }
+        current = first;
+        used = 0;
+    }
+};
+
+// =========================
+// 8️⃣ Batch Pricing Engine
+// =========================
+/*
+Pricing millions of orders one price() at a time means millions of virtual-call chains.
+PizzaBatch stores orders column-wise instead:
+
+    base     : [150, 200, 150, ...]   one entry per order
+    column 0 : [ 10,  20,   0, ...]   cost of the 1st topping (0 if the order has fewer toppings)
+    column 1 : [ 20,   0,   0, ...]   cost of the 2nd topping
+    ...
+
+total[i] = base[i] + column0[i] + column1[i] + ... is the same left-to-right sum that the
+decorator chain computes, so results match price() exactly. The kernel adds 8 orders at a
+time with GCC/Clang vector extensions (SSE/AVX/NEON depending on the target flags), streams
+each column once per block, and splits very large batches across threads.
+
+Trade-off: the number of columns is the largest topping count in the batch; a few orders with
+many toppings make every order pay for the extra (zero) columns.
+*/
+class PizzaBatch {
+    typedef int v8i __attribute__((vector_size(32)));
+    static const size_t LANES = 8;
+
+    vector<int> base;
+    vector<vector<int>> columns;
+
+    // totals[i] for i in [begin, end)
+    void priceRange(size_t begin, size_t end, int* totals) const {
+        size_t i = begin;
+        for (; i + LANES <= end; i += LANES) {
+            v8i sum;
+            memcpy(&sum, &base[i], sizeof(sum));
+            for (const vector<int>& column : columns) {
+                v8i cost;
+                memcpy(&cost, &column[i], sizeof(cost));
+                sum += cost;
+            }
+            memcpy(&totals[i], &sum, sizeof(sum));
+        }
+        for (; i < end; i++) {
+            int sum = base[i];
+            for (const vector<int>& column : columns) sum += column[i];
+            totals[i] = sum;
+        }
+    }
+
+public:
+    void reserve(size_t orders) { base.reserve(orders); }
+    size_t size() const { return base.size(); }
+    size_t columnCount() const { return columns.size(); }
+
+    // toppingCosts in the order the toppings were added
+    void add(int baseCost, const int* toppingCosts, size_t toppingCount) {
+        while (columns.size() < toppingCount) columns.emplace_back(base.size(), 0);
+        for (size_t k = 0; k < columns.size(); k++) {
+            columns[k].push_back(k < toppingCount ? toppingCosts[k] : 0);
+        }
+        base.push_back(baseCost);
+    }
+
+    // Records a decorated pizza by walking its layers (same walk as SealedPizza).
+    // Throws logic_error if a layer's layerCost() disagrees with its price().
+    void add(BasePizza* pizza) {
+        int costs[256];
+        size_t n = 0;
+        int sum = 0;
+        for (BasePizza* layer = pizza; layer != nullptr; layer = layer->wrapped()) {
+            if (n == 256) throw length_error("PizzaBatch: more than 255 toppings");
+            costs[n] = layer->layerCost();
+            sum += costs[n++];
+        }
+        if (sum != pizza->price()) throw logic_error("PizzaBatch: layer costs do not add up to price()");
+        reverse(costs, costs + n); // base first, then toppings in the order they were added
+        add(costs[0], costs + 1, n - 1);
+    }
+
+    // Fills totals (size() entries). Batches of at least `parallelThreshold` orders are split
+    // across `threads` threads (0 = hardware concurrency).
+    void priceAll(vector<int>& totals, size_t parallelThreshold = 1 << 20, unsigned threads = 0) const {
+        totals.resize(base.size());
+        if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+        if (base.size() < parallelThreshold || threads == 1) {
+            priceRange(0, base.size(), totals.data());
+            return;
+        }
+        // chunk boundaries are multiples of LANES so only the last chunk has a scalar tail
+        size_t chunk = (base.size() / threads + LANES) / LANES * LANES;
+        vector<thread> workers;
+        for (size_t begin = 0; begin < base.size(); begin += chunk) {
+            size_t end = min(base.size(), begin + chunk);
+            workers.emplace_back([this, begin, end, &totals] { priceRange(begin, end, totals.data()); });
+        }
+        for (thread& w : workers) w.join();
+    }
+};
+
+// =========================
+// 9️⃣ Description Rendering
+// =========================
+/*
+description() pushes every layer through cout. For rendering many orders:
+
+- render(buf, cap) writes the description into a caller-supplied buffer, snprintf-style:
+  at most cap-1 chars + '\0', and the return value is the full length (so a short buffer
+  can be detected and retried). Each layer only supplies its label(); the chain is walked once.
+- DescriptionCache keys orders by their layer types (base, topping sequence) and keeps the
+  rendered text per combination, so repeated combinations cost one hash lookup.
+  Prices never affect the key because they never appear in the text.
+  Not thread-safe: use one cache per thread.
+*/
+
+// Appends text at position len (the untruncated length so far) and returns the new length
+size_t appendText(char* buf, size_t cap, size_t len, const char* text) {
+    size_t n = strlen(text);
+    if (len < cap) {
+        size_t room = cap - 1 - len;
+        memcpy(buf + len, text, min(n, room));
+        buf[min(len + n, cap - 1)] = '\0';
+    }
+    return len + n;
+}
+
+size_t BasePizza::render(char* buf, size_t cap) {
+    if (cap > 0) buf[0] = '\0';
+    const char* labels[64];
+    size_t n = 0;
+    BasePizza* inner = nullptr; // first layer this walk cannot label itself
+    for (BasePizza* layer = this; layer != nullptr; layer = layer->wrapped()) {
+        const char* text = layer->label();
+        if (text == nullptr || n == 64) {
+            inner = layer;
+            break;
+        }
+        labels[n++] = text;
+    }
+    size_t len = 0;
+    if (inner == this) {
+        throw logic_error(string("render(): ") + typeid(*this).name() + " overrides neither label() nor render()");
+    }
+    // a SealedPizza or Decorated<> (or a very deep chain) renders its own part first
+    if (inner != nullptr) len = inner->render(buf, cap);
+    while (n > 0) len = appendText(buf, cap, len, labels[--n]); // innermost first
+    return len;
+}
+
+template <typename Base, typename... Toppings>
+size_t Decorated<Base, Toppings...>::render(char* buf, size_t cap) {
+    size_t len = base.Base::render(buf, cap);
+    ((len = appendText(buf, cap, len, Toppings::label)), ...);
+    return len;
+}
+
+class DescriptionCache {
+    static const size_t MAX_LAYERS = 16;
+    struct Key {
+        array<const type_info*, MAX_LAYERS> types{}; // outermost layer first
+        size_t count = 0;
+        bool operator==(const Key& other) const {
+            return count == other.count && equal(types.begin(), types.begin() + count, other.types.begin());
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            size_t h = k.count;
+            // type_info addresses are stable for the program's lifetime; hashing them avoids
+            // hash_code(), which hashes the mangled name on every call
+            for (size_t i = 0; i < k.count; i++) h = (h ^ reinterpret_cast<uintptr_t>(k.types[i])) * 0x9E3779B97F4A7C15ull;
+            return h;
+        }
+    };
+    unordered_map<Key, string, KeyHash> rendered;
+    size_t maxEntries;
+    string scratch; // holds uncacheable renders
+
+    // Fails for chains that are too deep
+    bool makeKey(BasePizza* pizza, Key& key) {
+        for (BasePizza* layer = pizza; layer != nullptr; layer = layer->wrapped()) {
+            if (key.count == MAX_LAYERS) return false;
+            key.types[key.count++] = &typeid(*layer);
+        }
+        return true;
+    }
+
+    // Only label()-based text depends on nothing but the layer types
+    static bool cacheable(BasePizza* pizza) {
+        for (BasePizza* layer = pizza; layer != nullptr; layer = layer->wrapped()) {
+            if (layer->label() == nullptr) return false;
+        }
+        return true;
+    }
+
+    static string renderToString(BasePizza* pizza) {
+        char small[128];
+        size_t len = pizza->render(small, sizeof(small));
+        if (len < sizeof(small)) return string(small, len);
+        string big(len, '\0');
+        pizza->render(big.data(), len + 1);
+        return big;
+    }
+
+public:
+    long long hits = 0, misses = 0, uncacheable = 0;
+
+    DescriptionCache(size_t maxEntries = 4096) { this->maxEntries = maxEntries; }
+
+    // The returned view stays valid until the next call on this cache
+    string_view get(BasePizza* pizza) {
+        Key key;
+        if (!makeKey(pizza, key)) {
+            uncacheable++;
+            scratch = renderToString(pizza);
+            return scratch;
+        }
+        auto it = rendered.find(key);
+        if (it != rendered.end()) {
+            hits++;
+            return it->second;
+        }
+        if (!cacheable(pizza)) {
+            uncacheable++;
+            scratch = renderToString(pizza);
+            return scratch;
+        }
+        misses++;
+        if (rendered.size() >= maxEntries) {
+            scratch = renderToString(pizza);
+            return scratch;
+        }
+        return rendered.emplace(key, renderToString(pizza)).first->second;
+    }
+
+    // Cached render into a caller buffer, same contract as BasePizza::render
+    size_t renderTo(BasePizza* pizza, char* buf, size_t cap) {
+        string_view text = get(pizza);
+        if (cap > 0) {
+            size_t n = min(text.size(), cap - 1);
+            memcpy(buf, text.data(), n);
+            buf[n] = '\0';
+        }
+        return text.size();
+    }
+
+    double hitRate() const {
+        long long total = hits + misses + uncacheable;
+        return total ? double(hits) / total : 0.0;
+    }
+    size_t size() const { return rendered.size(); }
+};
+
+// =========================
+// 🔟 Benchmarks
+// =========================
+// Builds Margerita + `depth` alternating toppings; returns the outermost layer.
+// `chain` receives every layer so the caller can free them.
+BasePizza* buildChain(int depth, vector<BasePizza*>& chain) {
     BasePizza* pizza = new Margerita(150);
+    chain.push_back(pizza);
+    for (int i = 0; i < depth; i++) {
+        if (i % 2 == 0) pizza = new CheeseTopping(pizza, 10);
+        else pizza = new PaneerTopping(pizza, 20);
+        chain.push_back(pizza);
+    }
+    return pizza;
+}
+
+// A topping written before layerCost() existed: it only overrides price().
+class OliveTopping : public PizzaDecorator {
+    int cost;
+public:
+    OliveTopping(BasePizza* pizza, int cost) : PizzaDecorator(pizza) { this->cost = cost; }
+
+    void description() override {
+        pizza->description();
+        cout << " with added Olive Topping";
+    }
+    int price() override { return pizza->price() + cost; }
+};
+
+void benchmarkSealing() {
+    const int QUERIES = 2000000;
+    {
+        OliveTopping olives(new CheeseTopping(new Margerita(150), 10), 25);
+        SealedPizza sealed(&olives);
+        PizzaBatch batch;
+        batch.add(&olives);
+        vector<int> totals;
+        batch.priceAll(totals);
+        printf("seal check: chain price %d, sealed price %d, batch price %d%s\n", olives.price(), sealed.price(),
+               totals[0], olives.price() == sealed.price() && olives.price() == totals[0] ? "" : "  MISMATCH");
+        char text[128];
+        try {
+            olives.render(text, sizeof(text));
+            printf("render check: OliveTopping rendered as \"%s\"  MISMATCH\n", text);
+        } catch (const logic_error&) {
+            printf("render check: OliveTopping without label() is rejected\n");
+        }
+        deleteChain(olives.wrapped());
+    }
+    cout << "depth  chain ns/price  sealed ns/price" << endl;
+    for (int depth = 1; depth <= 64; depth *= 2) {
+        vector<BasePizza*> chain;
+        BasePizza* pizza = buildChain(depth, chain);
+        SealedPizza* sealed = seal(pizza);
+        BasePizza* views[2] = {pizza, sealed};
+        double ns[2];
+        volatile long long sink = 0; // keeps the loops from being optimized away
+        for (int v = 0; v < 2; v++) {
+            auto start = chrono::steady_clock::now();
+            long long sum = 0;
+            for (int q = 0; q < QUERIES; q++) sum += views[v]->price();
+            sink = sink + sum;
+            ns[v] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / QUERIES;
+        }
+        printf("%5d  %14.2f  %15.2f\n", depth, ns[0], ns[1]);
+        delete sealed;
+        for (BasePizza* layer : chain) delete layer;
+    }
+}
+
+// Builds and prices Margerita + Cheese + Paneer orders through the runtime chain
+// and through Decorated<>, both via BasePizza* and via the concrete type.
+void benchmarkStaticComposition() {
+    const int ORDERS = 1000000;
+    volatile long long sink = 0;
+    auto timeIt = [&](const char* label, auto body) {
+        auto start = chrono::steady_clock::now();
+        long long sum = 0;
+        for (int i = 0; i < ORDERS; i++) sum += body(i);
+        sink = sink + sum;
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ORDERS;
+        printf("  %-36s %8.2f ns/order\n", label, ns);
+    };
+    cout << "Margerita + Cheese + Paneer, build + price():" << endl;
+    timeIt("dynamic chain (3 new, 3 calls)", [](int i) {
+        BasePizza* base = new Margerita(150 + (i & 7));
+        BasePizza* cheese = new CheeseTopping(base, 10);
+        BasePizza* paneer = new PaneerTopping(cheese, 20);
+        int p = paneer->price();
+        delete paneer; delete cheese; delete base;
+        return p;
+    });
+    timeIt("Decorated<> on the stack", [](int i) {
+        Decorated<Margerita, Cheese, Paneer> pizza(150 + (i & 7));
+        return pizza.price();
+    });
+
+    cout << "price() only, same pizza:" << endl;
+    BasePizza* volatile dynamicPizza = new PaneerTopping(new CheeseTopping(new Margerita(150), 10), 20);
+    Decorated<Margerita, Cheese, Paneer> staticPizza(150);
+    BasePizza* volatile staticAsBase = &staticPizza; // volatile: keep the call virtual
+    timeIt("dynamic chain via BasePizza*", [&](int) { return dynamicPizza->price(); });
+    timeIt("Decorated<> via BasePizza*", [&](int) { return staticAsBase->price(); });
+    timeIt("Decorated<> via concrete type", [&](int) { return staticPizza.price(); });
+    printf("  object size: dynamic chain %zu bytes in 3 allocations, Decorated<> %zu bytes inline\n",
+           sizeof(Margerita) + sizeof(CheeseTopping) + sizeof(PaneerTopping), sizeof(staticPizza));
+
+    deleteChain(dynamicPizza);
+}
+
+// Orders of `toppings` layers built with new/deleteChain versus one reused OrderArena.
+void benchmarkArena() {
+    const int ORDERS = 500000;
+    volatile long long sink = 0;
+    cout << "toppings  heap allocs/order  heap orders/s  arena allocs/order  arena orders/s" << endl;
+    for (int toppings : {2, 8, 32}) {
+        // every heap allocation either path makes: pizza layers and arena blocks
+        auto heapAllocations = [] { return BasePizza::heapLayers.load() + OrderArena::blocksAllocated.load(); };
+        long long allocs = heapAllocations();
+        auto start = chrono::steady_clock::now();
+        long long sum = 0;
+        for (int i = 0; i < ORDERS; i++) {
+            BasePizza* pizza = new Margerita(150);
+            for (int t = 0; t < toppings; t++) {
+                if (t % 2 == 0) pizza = new CheeseTopping(pizza, 10);
+                else pizza = new PaneerTopping(pizza, 20);
+            }
+            sum += pizza->price();
+            deleteChain(pizza);
+        }
+        double heapSecs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        double heapAllocsPerOrder = double(heapAllocations() - allocs) / ORDERS;
+
+        OrderArena arena(4096);
+        allocs = heapAllocations();
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < ORDERS; i++) {
+            BasePizza* pizza = arena.make<Margerita>(150);
+            for (int t = 0; t < toppings; t++) {
+                if (t % 2 == 0) pizza = arena.make<CheeseTopping>(pizza, 10);
+                else pizza = arena.make<PaneerTopping>(pizza, 20);
+            }
+            sum += pizza->price();
+            arena.release();
+        }
+        double arenaSecs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        double arenaAllocsPerOrder = double(heapAllocations() - allocs) / ORDERS;
+        sink = sink + sum;
+        printf("%8d  %17.2f  %13.0f  %18.2f  %14.0f\n", toppings, heapAllocsPerOrder, ORDERS / heapSecs,
+               arenaAllocsPerOrder, ORDERS / arenaSecs);
+    }
+}
+
+// 10M orders with 0-4 random toppings: virtual price() loop versus PizzaBatch.
+void benchmarkBatchPricing() {
+    const size_t ORDERS = 10000000;
+    mt19937 rng(7);
+    OrderArena arena(64 << 20);
+    vector<BasePizza*> orders;
+    orders.reserve(ORDERS);
+    PizzaBatch batch;
+    batch.reserve(ORDERS);
+    for (size_t i = 0; i < ORDERS; i++) {
+        BasePizza* pizza = (rng() % 2) ? (BasePizza*)arena.make<Margerita>(150 + rng() % 50)
+                                       : (BasePizza*)arena.make<Farmhouse>(200 + rng() % 50);
+        int toppings = rng() % 5;
+        for (int t = 0; t < toppings; t++) {
+            if (rng() % 2) pizza = arena.make<CheeseTopping>(pizza, 10 + rng() % 5);
+            else pizza = arena.make<PaneerTopping>(pizza, 20 + rng() % 5);
+        }
+        orders.push_back(pizza);
+        batch.add(pizza);
+    }
+
+    vector<int> expected(ORDERS);
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < ORDERS; i++) expected[i] = orders[i]->price();
+    double virtualSecs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("%zu orders, %zu topping columns\n", ORDERS, batch.columnCount());
+    printf("  virtual price() loop    %8.1f ms  %6.1f M orders/s\n", virtualSecs * 1e3, ORDERS / virtualSecs / 1e6);
+
+    unsigned many = max(4u, thread::hardware_concurrency());
+    vector<int> totals(ORDERS); // allocated up front so page faults are not timed
+    for (unsigned threads : {1u, many}) {
+        start = chrono::steady_clock::now();
+        batch.priceAll(totals, 1 << 20, threads);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        size_t mismatches = 0;
+        for (size_t i = 0; i < ORDERS; i++) mismatches += totals[i] != expected[i];
+        printf("  batch, %2u thread(s)     %8.1f ms  %6.1f M orders/s  mismatches=%zu\n", threads, secs * 1e3,
+               ORDERS / secs / 1e6, mismatches);
+    }
+}
+
+// Renders 1M orders drawn from 62 base/topping combinations:
+// description() captured into a string, render() into a buffer, and the cache.
+void benchmarkRendering() {
+    const int ORDERS = 1000000;
+    mt19937 rng(11);
+    OrderArena arena(1 << 20);
+    vector<BasePizza*> orders;
+    for (int i = 0; i < 4096; i++) {
+        BasePizza* pizza = (rng() % 2) ? (BasePizza*)arena.make<Margerita>(150) : (BasePizza*)arena.make<Farmhouse>(200);
+        int toppings = rng() % 5;
+        for (int t = 0; t < toppings; t++) {
+            if (rng() % 2) pizza = arena.make<CheeseTopping>(pizza, 10);
+            else pizza = arena.make<PaneerTopping>(pizza, 20);
+        }
+        orders.push_back(pizza);
+    }
+    ostringstream captured; // what it takes to get description() as text today
+    char buf[256];
+    volatile size_t sink = 0;
+    auto timeIt = [&](const char* label, auto body) {
+        auto start = chrono::steady_clock::now();
+        size_t sum = 0;
+        for (int i = 0; i < ORDERS; i++) sum += body(orders[i % orders.size()]);
+        sink = sink + sum;
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        printf("  %-28s %8.2f M renders/s\n", label, ORDERS / secs / 1e6);
+    };
+    streambuf* old = cout.rdbuf(captured.rdbuf());
+    timeIt("description() captured", [&](BasePizza* p) {
+        captured.str("");
+        p->description();
+        return captured.str().size();
+    });
+    cout.rdbuf(old);
+    timeIt("render() into buffer", [&](BasePizza* p) { return p->render(buf, sizeof(buf)); });
+    DescriptionCache cache;
+    timeIt("DescriptionCache::renderTo()", [&](BasePizza* p) { return cache.renderTo(p, buf, sizeof(buf)); });
+    printf("  cache: %zu combinations, hits=%lld misses=%lld uncacheable=%lld hit rate=%.4f\n", cache.size(),
+           cache.hits, cache.misses, cache.uncacheable, cache.hitRate());
+}
+
+// =========================
+// 1️⃣1️⃣ Usage / Test
+// =========================
+int main(int argc, char** argv) {
+    // All layers of this order live in one arena and are released together
+    OrderArena order;
+
+    // Create base pizza
+    BasePizza* pizza = order.make<Margerita>(150);
     pizza->description();
     cout << " -> Price: " << pizza->price() << endl;
 
     // Add Cheese topping dynamically
-    pizza = new CheeseTopping(pizza, 10);
+    pizza = order.make<CheeseTopping>(pizza, 10);
     pizza->description();
     cout << " -> Price: " << pizza->price() << endl;
 
     // Add Paneer topping dynamically
-    pizza = new PaneerTopping(pizza, 20);
+    pizza = order.make<PaneerTopping>(pizza, 20);
     pizza->description();
     cout << " -> Price: " << pizza->price() << endl;
 
-    // Cleanup (important for memory management)
-    delete pizza;
+    // Seal the finished order: price() no longer walks the chain
+    SealedPizza* sealed = seal(pizza);
+    sealed->description();
+    cout << " -> Sealed Price: " << sealed->price() << " (" << sealed->layerCount() << " layers)" << endl;
+    delete sealed;
+
+    // Render into a buffer / through the cache instead of printing layer by layer
+    char text[128];
+    pizza->render(text, sizeof(text));
+    DescriptionCache descriptions;
+    descriptions.get(pizza);
+    cout << "Rendered: " << text << " | cached: " << descriptions.get(pizza)
+         << " (hit rate " << descriptions.hitRate() << ")" << endl;
+
+    // Price several orders at once from columnar storage
+    PizzaBatch batch;
+    batch.add(pizza);
+    int farmhouseToppings[] = {10, 10, 20};
+    batch.add(200, farmhouseToppings, 3);
+    vector<int> totals;
+    batch.priceAll(totals);
+    cout << "Batch totals: " << totals[0] << ", " << totals[1] << endl;
+
+    // Cleanup (important for memory management): frees every layer, not just the outermost
+    order.release();
+
+    // Same pizza composed at compile time: no heap layers, price() folds to base + 30
+    static_assert(Decorated<Margerita, Cheese, Paneer>::toppingCost == 30, "toppings fold to a constant");
+    Decorated<Margerita, Cheese, Paneer> fixedOrder(150);
+    fixedOrder.description();
+    cout << " -> Compile-time Price: " << fixedOrder.price() << endl;
+    Decorated<Margerita, Cheese, Paneer> repeatOrder(fixedOrder); // plain copy, the base is copied inline
+    cout << "Repeat order price: " << repeatOrder.price() << endl;
+
+    // Run "./decorator bench" for the decorator benchmarks
+    if (argc > 1 && string(argv[1]) == "bench") {
+        benchmarkSealing();
+        benchmarkStaticComposition();
+        benchmarkArena();
+        benchmarkBatchPricing();
+        benchmarkRendering();
+    }
 
     return 0;
 }
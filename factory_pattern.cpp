@@ -1,42 +1,147 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <chrono>
+#include <random>
+#include <cstdio>
+using namespace std;
+
 class Vehicle{
     public:
-    
+
   virtual void drive()=0;
   virtual ~Vehicle() = default;
 };
 
+// Maps a type name to the function that creates it. Lookup is one hash of the
+// string_view plus one probe, however many types are registered.
+class VehicleRegistry{
+  public:
+  using Creator=Vehicle*(*)();
+
+  private:
+  struct Hash{
+      using is_transparent=void;
+      size_t operator()(string_view s) const{ return hash<string_view>()(s); }
+  };
+  unordered_map<string,Creator,Hash,equal_to<>> creators;
+
+  public:
+  // Returns false if the name is already taken; the first registration wins.
+  bool add(string_view type,Creator create){
+      return creators.emplace(string(type),create).second;
+  }
+  Vehicle* create(string_view type) const{
+      auto it=creators.find(type);
+      if(it==creators.end()){
+          throw invalid_argument("unknown vehicle type: \""+string(type)+"\"");
+      }
+      return it->second();
+  }
+  size_t size() const{ return creators.size(); }
+};
+
+class VehicleFactory{
+    public:
+  // Function-local static, so registrations from other translation units'
+  // static initializers never see it unconstructed.
+  static VehicleRegistry& registry(){
+      static VehicleRegistry instance;
+      return instance;
+  }
+  // Throws invalid_argument for a type nobody registered.
+  static Vehicle* createVehicle(string_view vehicleType){
+      return registry().create(vehicleType);
+  }
+};
+
+// Products register themselves next to their definition, so adding a type
+// never touches the factory.
+template<typename T>
+struct RegisterVehicle{
+  explicit RegisterVehicle(string_view type){
+      if(!VehicleFactory::registry().add(type,[]()->Vehicle*{ return new T(); })){
+          throw logic_error("vehicle type registered twice: \""+string(type)+"\"");
+      }
+  }
+};
+
 class Car : public Vehicle{
     public:
   void drive(){
       cout<<"Car is driving"<<endl;
-  }  
+  }
 };
+static RegisterVehicle<Car> registerCar("Car");
+
 class Bus : public Vehicle{
     public:
   void drive(){
       cout<<"Bus is driving"<<endl;
-  }  
+  }
 };
+static RegisterVehicle<Bus> registerBus("Bus");
 
-class VehicleFactory{
-    public:
-  static Vehicle* createVehicle(string vehicleType){
-      Vehicle* vehicle;
-      
-      if(vehicleType=="Car"){
-          vehicle=new Car();
-      }
-      else if(vehicleType=="Bus"){
-          vehicle=new Bus();
+// =========================
+// Benchmark (run with: ./a.out bench)
+// =========================
+
+// Creation cost as the number of registered types grows: the old if/else
+// chain (a linear scan of string compares) against the hashed registry.
+void benchmarkCreation(){
+  const int CREATES=2000000;
+  printf("  %-8s %20s %20s\n","types","if/else chain (ns)","registry (ns)");
+  for(int types:{2,8,32,128,512}){
+      vector<string> names;
+      for(int i=0;i<types;i++) names.push_back("VehicleType"+to_string(i));
+      vector<pair<string,VehicleRegistry::Creator>> chain;
+      VehicleRegistry registry;
+      for(int i=0;i<types;i++){
+          VehicleRegistry::Creator create=(i%2)?[]()->Vehicle*{ return new Bus(); }:[]()->Vehicle*{ return new Car(); };
+          chain.emplace_back(names[i],create);
+          registry.add(names[i],create);
       }
-      return vehicle;
-  }  
-};
-int main()
+      mt19937 rng(25);
+      vector<string_view> requests;
+      for(int i=0;i<4096;i++) requests.push_back(names[rng()%types]);
+
+      auto timeIt=[&](auto create){
+          auto start=chrono::steady_clock::now();
+          for(int i=0;i<CREATES;i++) delete create(requests[i&4095]);
+          return chrono::duration<double>(chrono::steady_clock::now()-start).count()*1e9/CREATES;
+      };
+      double scan=timeIt([&](string_view type)->Vehicle*{
+          for(auto& [name,create]:chain){
+              if(name==type) return create();
+          }
+          return nullptr;
+      });
+      double hashed=timeIt([&](string_view type){ return registry.create(type); });
+      printf("  %-8d %20.1f %20.1f\n",types,scan,hashed);
+  }
+}
+
+int main(int argc,char** argv)
 {
+    if(argc>1 && string(argv[1])=="bench"){
+        cout<<"Vehicle creation cost:"<<endl;
+        benchmarkCreation();
+        return 0;
+    }
     string vtype;
     cin>>vtype;
-    Vehicle* vehicle=VehicleFactory::createVehicle(vtype);
-    vehicle->drive();
+    try{
+        Vehicle* vehicle=VehicleFactory::createVehicle(vtype);
+        vehicle->drive();
+        delete vehicle;
+    }
+    catch(const invalid_argument& e){
+        cout<<e.what()<<endl;
+        return 1;
+    }
     return 0;
 }
@@ -1,23 +1,99 @@
 #include <iostream>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <cstdint>
+#include <stdexcept>
+#include <random>
+#include <cstring>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 using namespace std;
 
+// Benchmark-only allocation accounting: while an AllocationCounter is alive,
+// operator new on the same thread adds to it (requested bytes, allocator
+// overhead not included). Outside a counter, new is plain malloc.
+struct AllocationCounter{
+    long long allocations=0;
+    long long bytes=0;
+    AllocationCounter* outer;
+    static AllocationCounter*& active(){
+        thread_local AllocationCounter* current=nullptr;
+        return current;
+    }
+    AllocationCounter():outer(active()){ active()=this; }
+    ~AllocationCounter(){ active()=outer; }
+    AllocationCounter(const AllocationCounter&)=delete;
+    AllocationCounter& operator=(const AllocationCounter&)=delete;
+};
+// noinline: GCC warns about mismatched new/delete when it sees malloc/free inlined into callers
+__attribute__((noinline)) void* operator new(size_t n){
+    if(AllocationCounter* counter=AllocationCounter::active()){
+        counter->allocations++;
+        counter->bytes+=n;
+    }
+    if(void* p=malloc(n?n:1)) return p;
+    throw bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept{ free(p); }
+__attribute__((noinline)) void operator delete(void* p,size_t) noexcept{ free(p); }
+
+// Interns repeated attribute strings (bowling/batting styles): every distinct
+// value is stored once and handed out as a stable reference. Lookups take a
+// string_view and do not allocate when the value is already interned.
+class StringPool{
+    struct Hash{
+        using is_transparent=void;
+        size_t operator()(string_view s) const{ return hash<string_view>()(s); }
+    };
+    unordered_set<string,Hash,equal_to<>> pool; // node-based: references stay valid
+
+public:
+    const string& intern(string_view s){
+        auto it=pool.find(s);
+        if(it==pool.end()) it=pool.emplace(s).first;
+        return *it;
+    }
+    size_t size() const{ return pool.size(); }
+};
+
 // Use Case: Flyweight Pattern is used to save memory by sharing common data among many objects, e.g., managing cricket players across multiple matches.
 // Flyweight class - stores intrinsic (shared) attributes of a player
 class PlayerFlyweight{
-    string name;        // intrinsic attribute: player name
-    string bowlingtype; // intrinsic attribute: bowling style
-    string battingtype; // intrinsic attribute: batting style
+    string name;                // intrinsic attribute: player name
+    const string* bowlingtype;  // intrinsic attribute: bowling style (interned, shared)
+    const string* battingtype;  // intrinsic attribute: batting style (interned, shared)
 
 public:
-    // Constructor sets intrinsic attributes
-    PlayerFlyweight(string name,string bowlingtype,string battingtype){
-        this->name=name;
+    // Constructor sets intrinsic attributes; the styles are pointers into a
+    // StringPool, taken by pointer so a temporary string cannot bind here
+    PlayerFlyweight(string_view name,const string* bowlingtype,const string* battingtype){
+        this->name=string(name);
         this->bowlingtype=bowlingtype;
         this->battingtype=battingtype;
     }
 
+    const string& getName() const{ return name; }
+    const string& getBowlingType() const{ return *bowlingtype; }
+    const string& getBattingType() const{ return *battingtype; }
+
     // Display method uses extrinsic attributes (unique per match)
     void display(int runs,int wickets){
         // runs and wickets change for every match → extrinsic attributes
@@ -25,29 +101,943 @@ public:
     }
 };
 
+// Structured key over the intrinsic attributes. The factory stores keys whose
+// views point into the flyweight's own strings, and callers look up with views
+// of their arguments, so neither a hit nor the key itself allocates.
+struct PlayerKey{
+    string_view name;
+    string_view bowlingtype;
+    string_view battingtype;
+
+    bool operator==(const PlayerKey& other) const{
+        return name==other.name && bowlingtype==other.bowlingtype && battingtype==other.battingtype;
+    }
+};
+
+struct PlayerKeyHash{
+    size_t operator()(const PlayerKey& k) const{
+        size_t h=hash<string_view>()(k.name);
+        h^=hash<string_view>()(k.bowlingtype)+0x9e3779b97f4a7c15ULL+(h<<6)+(h>>2);
+        h^=hash<string_view>()(k.battingtype)+0x9e3779b97f4a7c15ULL+(h<<6)+(h>>2);
+        return h;
+    }
+};
+
 // Factory class to manage and reuse PlayerFlyweight objects
 class PlayerFactory{
-    vector<PlayerFlyweight*> p;                      // optional list to keep track of players
-    unordered_map<string,PlayerFlyweight*> mp;       // map for intrinsic attribute combination
+    unordered_map<PlayerKey,PlayerFlyweight*,PlayerKeyHash> mp; // map for intrinsic attribute combination
+    StringPool styles;                                         // bowling/batting types, stored once
 
 public:
-    PlayerFlyweight* getPlayer(string name,string bowlingtype,string battingtype){
-        // Create a unique key based on intrinsic attributes
-        string hash = name + '-' + bowlingtype + '-' + battingtype;
+    PlayerFactory()=default;
+    PlayerFactory(const PlayerFactory&)=delete;
+    PlayerFactory& operator=(const PlayerFactory&)=delete;
+    // The factory owns every flyweight it handed out
+    ~PlayerFactory(){
+        for(auto& [key,player]:mp) delete player;
+    }
+
+    PlayerFlyweight* getPlayer(string_view name,string_view bowlingtype,string_view battingtype){
+        // Look up with views of the arguments: one hash, one probe, no allocation
+        PlayerKey key{name,bowlingtype,battingtype};
+        auto it=mp.find(key);
+        if(it!=mp.end()) return it->second;
 
         // If player object for this combination doesn't exist, create it
-        if(mp.find(hash) == mp.end()){
-            PlayerFlyweight* player = new PlayerFlyweight(name, bowlingtype, battingtype);
-            cout << "New object created" << endl;
-            mp[hash] = player; // store in map for reuse
+        PlayerFlyweight* player=new PlayerFlyweight(name,&styles.intern(bowlingtype),&styles.intern(battingtype));
+        cout << "New object created" << endl;
+        // the stored key views the flyweight's own strings, which live as long as the entry
+        mp.emplace(PlayerKey{player->getName(),player->getBowlingType(),player->getBattingType()},player);
+        return player;
+    }
+
+    size_t size() const{ return mp.size(); }
+    size_t internedStyles() const{ return styles.size(); }
+};
+
+// Thread-safe factory for many concurrent callers. Keys are spread over
+// shards; each shard publishes an open-addressing table of atomic slots that
+// readers probe without taking any lock. Creation takes the shard mutex and
+// re-checks, so racing threads still get exactly one flyweight per key.
+class ConcurrentPlayerFactory{
+    struct Entry{
+        size_t hash;
+        PlayerFlyweight player;
+        Entry(size_t hash,string_view name,const string* bowlingtype,const string* battingtype)
+            :hash(hash),player(name,bowlingtype,battingtype){}
+    };
+    struct Table{
+        size_t mask;
+        unique_ptr<atomic<const Entry*>[]> slots;
+        explicit Table(size_t capacity):mask(capacity-1),slots(new atomic<const Entry*>[capacity]){
+            for(size_t i=0;i<capacity;i++) slots[i].store(nullptr,memory_order_relaxed);
+        }
+    };
+    struct alignas(64) Shard{
+        atomic<const Table*> table{nullptr};
+        mutex mtx;                        // serializes creation and growth
+        vector<unique_ptr<Entry>> entries;
+        vector<unique_ptr<Table>> tables; // the current table plus outgrown ones a reader may still be probing
+    };
+    vector<Shard> shards;
+    size_t shardMask;
+    mutex stylesMtx;
+    StringPool styles;
+    atomic<size_t> createdCount{0};
+
+    static bool matches(const Entry* e,size_t h,const PlayerKey& key){
+        return e->hash==h && PlayerKey{e->player.getName(),e->player.getBowlingType(),e->player.getBattingType()}==key;
+    }
+    static const Entry* probe(const Table* t,size_t h,const PlayerKey& key){
+        for(size_t i=h&t->mask;;i=(i+1)&t->mask){
+            const Entry* e=t->slots[i].load(memory_order_acquire);
+            if(!e) return nullptr;
+            if(matches(e,h,key)) return e;
+        }
+    }
+    static void place(const Table* t,const Entry* e){
+        size_t i=e->hash&t->mask;
+        while(t->slots[i].load(memory_order_relaxed)) i=(i+1)&t->mask;
+        t->slots[i].store(e,memory_order_release);
+    }
+    // Keeps the table at most half full. Caller holds the shard mutex.
+    static const Table* reserveSlot(Shard& shard){
+        const Table* t=shard.table.load(memory_order_relaxed);
+        if(t && 2*(shard.entries.size()+1)<=t->mask+1) return t;
+        size_t capacity=t?2*(t->mask+1):16;
+        auto grown=make_unique<Table>(capacity);
+        for(const auto& e:shard.entries) place(grown.get(),e.get());
+        t=grown.get();
+        shard.tables.push_back(move(grown));
+        shard.table.store(t,memory_order_release);
+        return t;
+    }
+
+public:
+    explicit ConcurrentPlayerFactory(size_t shardCount=64){
+        size_t n=1;
+        while(n<shardCount) n<<=1;
+        shards=vector<Shard>(n);
+        shardMask=n-1;
+    }
+
+    PlayerFlyweight* getPlayer(string_view name,string_view bowlingtype,string_view battingtype){
+        PlayerKey key{name,bowlingtype,battingtype};
+        size_t h=PlayerKeyHash()(key);
+        Shard& shard=shards[(h>>48)&shardMask];
+
+        // Read path: no lock, no allocation
+        if(const Table* t=shard.table.load(memory_order_acquire)){
+            if(const Entry* e=probe(t,h,key)) return const_cast<PlayerFlyweight*>(&e->player);
+        }
+
+        // Miss: the first thread to take the shard lock creates the flyweight
+        lock_guard<mutex> lock(shard.mtx);
+        if(const Table* t=shard.table.load(memory_order_relaxed)){
+            if(const Entry* e=probe(t,h,key)) return const_cast<PlayerFlyweight*>(&e->player);
+        }
+        const Table* t=reserveSlot(shard);
+        unique_ptr<Entry> entry;
+        {
+            lock_guard<mutex> stylesLock(stylesMtx);
+            entry=make_unique<Entry>(h,name,&styles.intern(bowlingtype),&styles.intern(battingtype));
+        }
+        place(t,entry.get());
+        shard.entries.push_back(move(entry));
+        createdCount.fetch_add(1,memory_order_relaxed);
+        return &shard.entries.back()->player;
+    }
+
+    size_t created() const{ return createdCount.load(memory_order_relaxed); }
+};
+
+// Flyweight cache with a memory cap for long-running processes whose key space
+// churns. Callers hold PlayerRef handles; an entry with no live handle can be
+// evicted by a CLOCK sweep once the cache is over its cap. Entries still
+// referenced are never evicted, so the cap is exceeded only while every entry
+// is in use.
+class BoundedPlayerCache{
+    struct Entry{
+        unique_ptr<PlayerFlyweight> player; // null while the slot is free
+        size_t bytes=0;
+        uint32_t refs=0;
+        bool recentlyUsed=false;            // CLOCK reference bit
+    };
+    vector<Entry> entries;
+    vector<uint32_t> freeSlots;
+    unordered_map<PlayerKey,uint32_t,PlayerKeyHash> index; // keys view the entry's own strings
+    StringPool styles;
+    size_t capBytes;
+    size_t usedBytes=0;
+    size_t hand=0;
+
+    // What one entry costs: the flyweight, a heap-allocated name, and its index node.
+    static size_t entryBytes(const PlayerFlyweight& p){
+        size_t nameHeap=p.getName().capacity()>15?p.getName().capacity()+1:0;
+        return sizeof(Entry)+sizeof(PlayerFlyweight)+nameHeap+sizeof(pair<const PlayerKey,uint32_t>)+2*sizeof(void*);
+    }
+    void evict(uint32_t slot){
+        Entry& e=entries[slot];
+        index.erase(PlayerKey{e.player->getName(),e.player->getBowlingType(),e.player->getBattingType()});
+        usedBytes-=e.bytes;
+        e.player.reset();
+        e.bytes=0;
+        freeSlots.push_back(slot);
+        evictions++;
+    }
+    // Sweeps at most two turns of the clock: the first clears reference bits,
+    // the second finds an unreferenced entry if one exists.
+    void shrinkToCap(){
+        size_t steps=0;
+        while(usedBytes>capBytes && steps<2*entries.size()){
+            Entry& e=entries[hand];
+            uint32_t slot=(uint32_t)hand;
+            hand=(hand+1)%entries.size();
+            steps++;
+            if(!e.player || e.refs>0) continue;
+            if(e.recentlyUsed){
+                e.recentlyUsed=false;
+                continue;
+            }
+            evict(slot);
+            steps=0;
+        }
+    }
+    void release(uint32_t slot){
+        entries[slot].refs--;
+    }
+
+public:
+    // Ref-counted handle to a cached flyweight; the entry stays resident while any copy is alive.
+    class PlayerRef{
+        BoundedPlayerCache* cache=nullptr;
+        uint32_t slot=0;
+
+    public:
+        PlayerRef()=default;
+        PlayerRef(BoundedPlayerCache* cache,uint32_t slot):cache(cache),slot(slot){ cache->entries[slot].refs++; }
+        PlayerRef(const PlayerRef& other):PlayerRef(){ *this=other; }
+        PlayerRef(PlayerRef&& other) noexcept:cache(other.cache),slot(other.slot){ other.cache=nullptr; }
+        PlayerRef& operator=(const PlayerRef& other){
+            if(other.cache) other.cache->entries[other.slot].refs++;
+            reset();
+            cache=other.cache;
+            slot=other.slot;
+            return *this;
+        }
+        PlayerRef& operator=(PlayerRef&& other) noexcept{
+            if(this!=&other){
+                reset();
+                cache=other.cache;
+                slot=other.slot;
+                other.cache=nullptr;
+            }
+            return *this;
+        }
+        ~PlayerRef(){ reset(); }
+
+        void reset(){
+            if(cache) cache->release(slot);
+            cache=nullptr;
+        }
+        explicit operator bool() const{ return cache!=nullptr; }
+        PlayerFlyweight* operator->() const{ return cache->entries[slot].player.get(); }
+        PlayerFlyweight& operator*() const{ return *cache->entries[slot].player; }
+    };
+
+    long long hits=0,misses=0,evictions=0;
+
+    explicit BoundedPlayerCache(size_t capBytes):capBytes(capBytes){}
+    BoundedPlayerCache(const BoundedPlayerCache&)=delete;
+    BoundedPlayerCache& operator=(const BoundedPlayerCache&)=delete;
+    ~BoundedPlayerCache(){
+        // outstanding PlayerRefs must not outlive the cache
+        for(const Entry& e:entries) assert(e.refs==0);
+    }
+
+    PlayerRef getPlayer(string_view name,string_view bowlingtype,string_view battingtype){
+        auto it=index.find(PlayerKey{name,bowlingtype,battingtype});
+        if(it!=index.end()){
+            hits++;
+            entries[it->second].recentlyUsed=true;
+            return PlayerRef(this,it->second);
+        }
+        misses++;
+        uint32_t slot;
+        if(!freeSlots.empty()){
+            slot=freeSlots.back();
+            freeSlots.pop_back();
+        }else{
+            slot=(uint32_t)entries.size();
+            entries.emplace_back();
+        }
+        Entry& e=entries[slot];
+        e.player=make_unique<PlayerFlyweight>(name,&styles.intern(bowlingtype),&styles.intern(battingtype));
+        e.bytes=entryBytes(*e.player);
+        e.recentlyUsed=true;
+        usedBytes+=e.bytes;
+        index.emplace(PlayerKey{e.player->getName(),e.player->getBowlingType(),e.player->getBattingType()},slot);
+        PlayerRef ref(this,slot); // pinned before shrinking so the new entry survives
+        shrinkToCap();
+        return ref;
+    }
+
+    size_t size() const{ return index.size(); }
+    size_t bytesInUse() const{ return usedBytes; }
+    size_t capacityBytes() const{ return capBytes; }
+    double hitRate() const{ return hits+misses?(double)hits/(hits+misses):0; }
+};
+
+// =========================
+// Compact flyweight store
+// =========================
+
+// Styles are a small closed set, so they are stored as one-byte ids instead of strings.
+enum class BowlingStyle : uint8_t{ None, RightArmFast, RightArmFastMedium, RightArmMedium, RightArmOffbreak,
+                                   RightArmLegbreak, SlowLeftArmOrthodox, LeftArmWristSpin, LeftArmFast, Count };
+enum class BattingStyle : uint8_t{ RightHand, LeftHand, Count };
+
+const char* const bowlingStyleNames[]={"None","Right arm fast","Right arm fast medium","Right arm medium",
+                                       "Right arm offbreak","Right arm legbreak","Slow left arm orthodox",
+                                       "Left arm wrist spin","Left arm fast"};
+const char* const battingStyleNames[]={"Right hand","Left hand"};
+
+template<typename Style,size_t N>
+Style styleFromName(const char* const (&names)[N],string_view name){
+    for(size_t i=0;i<N;i++){
+        if(name==names[i]) return (Style)i;
+    }
+    throw invalid_argument("unknown style: "+string(name));
+}
+
+// 32-bit index into a PlayerTable; stays valid for the lifetime of the table.
+struct PlayerHandle{
+    uint32_t id;
+    bool operator==(PlayerHandle other) const{ return id==other.id; }
+};
+
+// Rows and index slots use offsets rather than pointers, so the same bytes work
+// in memory and inside a mapped snapshot file.
+struct PlayerRow{
+    uint32_t nameOffset;
+    uint16_t nameLength;
+    BowlingStyle bowling;
+    BattingStyle batting;
+};
+struct PlayerIndexSlot{
+    uint64_t hash;
+    uint32_t row; // PlayerIndexSlot::EMPTY if unused
+    uint32_t reserved;
+    static const uint32_t EMPTY=UINT32_MAX;
+};
+static_assert(sizeof(PlayerRow)==8 && sizeof(PlayerIndexSlot)==16,"snapshot layout");
+
+// FNV-1a: unlike std::hash it is the same in every build, so hashes stored in a snapshot stay valid.
+inline uint64_t hashPlayer(string_view name,BowlingStyle bowling,BattingStyle batting){
+    uint64_t h=1469598103934665603ULL;
+    for(char c:name) h=(h^(uint8_t)c)*1099511628211ULL;
+    h=(h^(uint8_t)bowling)*1099511628211ULL;
+    h=(h^(uint8_t)batting)*1099511628211ULL;
+    return h;
+}
+
+// Probe shared by PlayerTable and MappedPlayerTable; indexSize is a power of two.
+inline uint32_t findPlayerRow(const PlayerRow* rows,const PlayerIndexSlot* index,size_t indexSize,const char* names,
+                              uint64_t h,string_view name,BowlingStyle bowling,BattingStyle batting){
+    if(indexSize==0) return PlayerIndexSlot::EMPTY;
+    size_t mask=indexSize-1;
+    for(size_t i=h&mask;index[i].row!=PlayerIndexSlot::EMPTY;i=(i+1)&mask){
+        const PlayerRow& r=rows[index[i].row];
+        if(index[i].hash==h && r.bowling==bowling && r.batting==batting &&
+           string_view(names+r.nameOffset,r.nameLength)==name){
+            return index[i].row;
+        }
+    }
+    return PlayerIndexSlot::EMPTY;
+}
+
+// All intrinsic state in one contiguous table: an 8-byte row per player and the
+// names packed into one character buffer. Rows are found through an
+// open-addressing index of handles.
+class PlayerTable{
+    vector<PlayerRow> rows;
+    string names;
+    vector<PlayerIndexSlot> index;
+
+    void insert(uint64_t h,uint32_t row){
+        size_t mask=index.size()-1;
+        size_t i=h&mask;
+        while(index[i].row!=PlayerIndexSlot::EMPTY) i=(i+1)&mask;
+        index[i]={h,row,0};
+    }
+    // Keeps the index at most half full.
+    void grow(){
+        if(2*(rows.size()+1)<=index.size()) return;
+        vector<PlayerIndexSlot> old;
+        old.swap(index);
+        index.assign(max<size_t>(16,old.size()*2),{0,PlayerIndexSlot::EMPTY,0});
+        for(const PlayerIndexSlot& slot:old){
+            if(slot.row!=PlayerIndexSlot::EMPTY) insert(slot.hash,slot.row);
         }
+    }
+
+public:
+    // Throws invalid_argument for names longer than 65535 bytes and
+    // length_error once the names buffer or the row ids would overflow 32 bits.
+    PlayerHandle getPlayer(string_view name,BowlingStyle bowling,BattingStyle batting){
+        if(name.size()>UINT16_MAX) throw invalid_argument("PlayerTable: name longer than 65535 bytes");
+        uint64_t h=hashPlayer(name,bowling,batting);
+        uint32_t row=findPlayerRow(rows.data(),index.data(),index.size(),names.data(),h,name,bowling,batting);
+        if(row!=PlayerIndexSlot::EMPTY) return {row};
+        if(names.size()+name.size()>UINT32_MAX) throw length_error("PlayerTable: names buffer would exceed 4 GiB");
+        if(rows.size()>=PlayerIndexSlot::EMPTY) throw length_error("PlayerTable: too many players");
+        grow();
+        row=(uint32_t)rows.size();
+        rows.push_back({(uint32_t)names.size(),(uint16_t)name.size(),bowling,batting});
+        names.append(name);
+        insert(h,row);
+        return {row};
+    }
+    PlayerHandle getPlayer(string_view name,string_view bowlingtype,string_view battingtype){
+        return getPlayer(name,styleFromName<BowlingStyle>(bowlingStyleNames,bowlingtype),
+                         styleFromName<BattingStyle>(battingStyleNames,battingtype));
+    }
+
+    string_view getName(PlayerHandle h) const{ return string_view(names).substr(rows[h.id].nameOffset,rows[h.id].nameLength); }
+    BowlingStyle getBowling(PlayerHandle h) const{ return rows[h.id].bowling; }
+    BattingStyle getBatting(PlayerHandle h) const{ return rows[h.id].batting; }
+    void display(PlayerHandle h,int runs,int wickets) const{
+        cout << getName(h) << " scored " << runs << " and took " << wickets << endl;
+    }
 
-        // Return existing object if already created
+    size_t size() const{ return rows.size(); }
+    size_t bytesUsed() const{
+        return rows.capacity()*sizeof(PlayerRow)+names.capacity()+index.capacity()*sizeof(PlayerIndexSlot);
+    }
+
+    // Writes the table as a snapshot that MappedPlayerTable can use in place.
+    void save(const char* path) const;
+};
+
+// Snapshot file: header, rows, index, names, each section 8-byte aligned and
+// located by its offset from the start of the file.
+struct PlayerSnapshotHeader{
+    char magic[8];     // "PLAYERS1"
+    uint32_t endian;   // 0x01020304 as written by the host
+    uint32_t rowCount;
+    uint64_t indexSize;
+    uint64_t namesBytes;
+    uint64_t rowsOffset;
+    uint64_t indexOffset;
+    uint64_t namesOffset;
+    uint64_t fileBytes;
+};
+static const char playerSnapshotMagic[8]={'P','L','A','Y','E','R','S','1'};
+
+inline uint64_t alignSnapshot(uint64_t offset){ return (offset+7)&~(uint64_t)7; }
+
+void PlayerTable::save(const char* path) const{
+    PlayerSnapshotHeader header{};
+    memcpy(header.magic,playerSnapshotMagic,sizeof(header.magic));
+    header.endian=0x01020304;
+    header.rowCount=(uint32_t)rows.size();
+    header.indexSize=index.size();
+    header.namesBytes=names.size();
+    header.rowsOffset=alignSnapshot(sizeof(header));
+    header.indexOffset=alignSnapshot(header.rowsOffset+rows.size()*sizeof(PlayerRow));
+    header.namesOffset=alignSnapshot(header.indexOffset+index.size()*sizeof(PlayerIndexSlot));
+    header.fileBytes=header.namesOffset+names.size();
+
+    string tmp=string(path)+".tmp";
+    int fd=::open(tmp.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+    if(fd<0) throw runtime_error("cannot create snapshot "+tmp+": "+strerror(errno));
+    auto writeAt=[&](uint64_t offset,const void* data,size_t bytes){
+        const char* p=(const char*)data;
+        while(bytes>0){
+            ssize_t n=pwrite(fd,p,bytes,offset);
+            if(n<0){
+                if(errno==EINTR) continue;
+                int err=errno;
+                close(fd);
+                throw runtime_error("cannot write snapshot "+tmp+": "+strerror(err));
+            }
+            p+=n;
+            offset+=n;
+            bytes-=n;
+        }
+    };
+    writeAt(0,&header,sizeof(header));
+    writeAt(header.rowsOffset,rows.data(),rows.size()*sizeof(PlayerRow));
+    writeAt(header.indexOffset,index.data(),index.size()*sizeof(PlayerIndexSlot));
+    writeAt(header.namesOffset,names.data(),names.size());
+    if(fsync(fd)!=0 || close(fd)!=0) throw runtime_error("cannot flush snapshot "+tmp+": "+strerror(errno));
+    // rename last, so a reader never maps a half-written file
+    if(rename(tmp.c_str(),path)!=0) throw runtime_error("cannot publish snapshot "+string(path)+": "+strerror(errno));
+}
+
+// Read-only PlayerTable served straight from a mapped snapshot: loading maps
+// the file and checks the header, with no per-entry parsing or allocation.
+// Handles are the same as in the table that was saved.
+class MappedPlayerTable{
+    void* base=MAP_FAILED;
+    size_t bytes=0;
+    const PlayerSnapshotHeader* header=nullptr;
+    const PlayerRow* rows=nullptr;
+    const PlayerIndexSlot* index=nullptr;
+    const char* names=nullptr;
+
+    // True if `count` items of `size` bytes starting at `offset` lie inside the file
+    bool fits(uint64_t offset,uint64_t count,uint64_t size) const{
+        return offset%8==0 && offset<=bytes && count<=(bytes-offset)/size;
+    }
+    bool headerValid() const{
+        const PlayerSnapshotHeader& h=*header;
+        bool indexShape=h.indexSize==0?h.rowCount==0:(h.indexSize&(h.indexSize-1))==0 && h.indexSize>h.rowCount;
+        return memcmp(h.magic,playerSnapshotMagic,sizeof(h.magic))==0 && h.endian==0x01020304 &&
+               h.fileBytes==bytes && indexShape &&
+               fits(h.rowsOffset,h.rowCount,sizeof(PlayerRow)) &&
+               fits(h.indexOffset,h.indexSize,sizeof(PlayerIndexSlot)) &&
+               h.namesOffset<=bytes && h.namesBytes==bytes-h.namesOffset;
+    }
+    // Every name inside the names section, every style a known id, every
+    // index slot empty or naming a real row, and at least one empty slot so
+    // probes terminate.
+    bool contentsValid() const{
+        for(uint32_t i=0;i<header->rowCount;i++){
+            const PlayerRow& r=rows[i];
+            if((uint64_t)r.nameOffset+r.nameLength>header->namesBytes) return false;
+            if(r.bowling>=BowlingStyle::Count || r.batting>=BattingStyle::Count) return false;
+        }
+        uint64_t empty=0;
+        for(uint64_t i=0;i<header->indexSize;i++){
+            if(index[i].row==PlayerIndexSlot::EMPTY) empty++;
+            else if(index[i].row>=header->rowCount) return false;
+        }
+        return header->indexSize==0 || empty>0;
+    }
+
+public:
+    // With verify (the default) every row and index slot is bounds-checked once
+    // at load, so a corrupt or truncated file is rejected instead of causing
+    // out-of-range reads later. verify=false only checks the header; use it
+    // for snapshots this process wrote itself.
+    explicit MappedPlayerTable(const char* path,bool verify=true){
+        int fd=::open(path,O_RDONLY);
+        if(fd<0) throw runtime_error("cannot open snapshot "+string(path)+": "+strerror(errno));
+        struct stat st;
+        if(fstat(fd,&st)!=0 || st.st_size<(off_t)sizeof(PlayerSnapshotHeader)){
+            close(fd);
+            throw runtime_error("snapshot too small: "+string(path));
+        }
+        bytes=st.st_size;
+        base=mmap(nullptr,bytes,PROT_READ,MAP_SHARED,fd,0);
+        close(fd);
+        if(base==MAP_FAILED) throw runtime_error("cannot map snapshot "+string(path)+": "+strerror(errno));
+
+        const char* p=(const char*)base;
+        header=(const PlayerSnapshotHeader*)p;
+        rows=(const PlayerRow*)(p+header->rowsOffset);
+        index=(const PlayerIndexSlot*)(p+header->indexOffset);
+        names=p+header->namesOffset;
+        if(!headerValid() || (verify && !contentsValid())){
+            munmap(base,bytes);
+            base=MAP_FAILED;
+            throw runtime_error("not a valid player snapshot: "+string(path));
+        }
+    }
+    ~MappedPlayerTable(){
+        if(base!=MAP_FAILED) munmap(base,bytes);
+    }
+    MappedPlayerTable(const MappedPlayerTable&)=delete;
+    MappedPlayerTable& operator=(const MappedPlayerTable&)=delete;
+
+    // Returns false if the player is not in the snapshot
+    bool findPlayer(string_view name,BowlingStyle bowling,BattingStyle batting,PlayerHandle& out) const{
+        uint32_t row=findPlayerRow(rows,index,header->indexSize,names,hashPlayer(name,bowling,batting),name,bowling,batting);
+        out={row};
+        return row!=PlayerIndexSlot::EMPTY;
+    }
+
+    string_view getName(PlayerHandle h) const{ return string_view(names+rows[h.id].nameOffset,rows[h.id].nameLength); }
+    BowlingStyle getBowling(PlayerHandle h) const{ return rows[h.id].bowling; }
+    BattingStyle getBatting(PlayerHandle h) const{ return rows[h.id].batting; }
+    size_t size() const{ return header->rowCount; }
+    size_t fileBytes() const{ return bytes; }
+};
+
+// Per-match extrinsic state as structure-of-arrays columns, so an aggregation
+// only streams the columns it reads: 7 bytes per record in total.
+class MatchStats{
+    vector<uint32_t> player;
+    vector<uint16_t> runs;
+    vector<uint8_t> wickets;
+
+public:
+    void reserve(size_t n){
+        player.reserve(n);
+        runs.reserve(n);
+        wickets.reserve(n);
+    }
+    void record(PlayerHandle h,int matchRuns,int matchWickets){
+        player.push_back(h.id);
+        runs.push_back((uint16_t)matchRuns);
+        wickets.push_back((uint8_t)matchWickets);
+    }
+    size_t size() const{ return player.size(); }
+    static constexpr size_t bytesPerRecord(){ return sizeof(uint32_t)+sizeof(uint16_t)+sizeof(uint8_t); }
+
+    // Totals indexed by PlayerHandle::id
+    vector<uint64_t> totalRuns(size_t players) const{
+        vector<uint64_t> totals(players,0);
+        for(size_t i=0;i<player.size();i++) totals[player[i]]+=runs[i];
+        return totals;
+    }
+    vector<uint64_t> totalWickets(size_t players) const{
+        vector<uint64_t> totals(players,0);
+        for(size_t i=0;i<player.size();i++) totals[player[i]]+=wickets[i];
+        return totals;
+    }
+    uint64_t sumRuns() const{
+        // 32-bit partial sums over blocks that cannot overflow keep the loop vectorized
+        uint64_t sum=0;
+        for(size_t begin=0;begin<runs.size();begin+=65536){
+            size_t end=min(runs.size(),begin+65536);
+            uint32_t block=0;
+            for(size_t i=begin;i<end;i++) block+=runs[i];
+            sum+=block;
+        }
+        return sum;
+    }
+};
+
+// =========================
+// Benchmarks (run with: ./a.out bench)
+// =========================
+
+// The previous factory, kept as the baseline: it builds a concatenated string
+// key per call and hashes it twice (find + operator[]).
+class LegacyPlayerFactory{
+    unordered_map<string,PlayerFlyweight*> mp;
+    StringPool styles;
+
+public:
+    PlayerFlyweight* getPlayer(string name,string bowlingtype,string battingtype){
+        string hash = name + '-' + bowlingtype + '-' + battingtype;
+        if(mp.find(hash) == mp.end()){
+            mp[hash] = new PlayerFlyweight(name,&styles.intern(bowlingtype),&styles.intern(battingtype));
+        }
         return mp[hash];
     }
 };
 
-int main()
+struct PlayerSpec{ const char* name; const char* bowling; const char* batting; };
+
+const PlayerSpec squad[] = {
+    {"Rohit Sharma","Right arm offbreak","Right hand"},
+    {"Shubman Gill","Right arm offbreak","Right hand"},
+    {"Virat Kohli","Right arm medium","Right hand"},
+    {"Shreyas Iyer","Right arm legbreak","Right hand"},
+    {"KL Rahul","None","Right hand"},
+    {"Hardik Pandya","Right arm fast medium","Right hand"},
+    {"Ravindra Jadeja","Slow left arm orthodox","Left hand"},
+    {"Kuldeep Yadav","Left arm wrist spin","Left hand"},
+    {"Jasprit Bumrah","Right arm fast","Right hand"},
+    {"Mohammed Siraj","Right arm fast","Right hand"},
+    {"Mohammed Shami","Right arm fast","Right hand"},
+};
+const int squadSize=sizeof(squad)/sizeof(squad[0]);
+
+// Hit path only: every player is created before timing starts.
+void benchmarkLookup(){
+    const int LOOKUPS=5000000;
+    volatile size_t sink=0;
+    auto timeIt=[&](const char* label,auto lookup){
+        for(int i=0;i<squadSize;i++) lookup(squad[i]); // warm up: all misses happen here
+        AllocationCounter counter;
+        auto start=chrono::steady_clock::now();
+        size_t sum=0;
+        for(int i=0;i<LOOKUPS;i++) sum+=(size_t)lookup(squad[i%squadSize]);
+        sink=sink+sum;
+        double secs=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+        double allocs=(double)counter.allocations/LOOKUPS;
+        printf("  %-32s %7.1f ns/lookup  %5.2f allocs/lookup\n",label,secs*1e9/LOOKUPS,allocs);
+    };
+
+    streambuf* old=cout.rdbuf(nullptr); // silence "New object created" during warm-up
+    LegacyPlayerFactory legacy;
+    PlayerFactory factory;
+    timeIt("string key, double lookup",[&](const PlayerSpec& s){ return legacy.getPlayer(s.name,s.bowling,s.batting); });
+    timeIt("structured key, single lookup",[&](const PlayerSpec& s){ return factory.getPlayer(s.name,s.bowling,s.batting); });
+    cout.rdbuf(old);
+    printf("  %zu flyweights share %zu interned style strings\n",factory.size(),factory.internedStyles());
+}
+
+// Lookup throughput as callers are added, against the same factory behind one mutex.
+void benchmarkConcurrentLookup(){
+    const int PLAYERS=4096;
+    const int LOOKUPS_PER_THREAD=200000;
+    const char* bowling[]={"Right arm fast","Right arm medium","Right arm offbreak","Slow left arm orthodox","None"};
+    const char* batting[]={"Right hand","Left hand"};
+    vector<string> names;
+    for(int i=0;i<PLAYERS;i++) names.push_back("Player "+to_string(i));
+    auto specOf=[&](int i){ return PlayerSpec{names[i].c_str(),bowling[i%5],batting[i%2]}; };
+
+    // Racing first requests: every thread asks for every key at once
+    {
+        ConcurrentPlayerFactory factory;
+        vector<thread> threads;
+        vector<vector<PlayerFlyweight*>> seen(8,vector<PlayerFlyweight*>(PLAYERS));
+        for(int t=0;t<8;t++){
+            threads.emplace_back([&,t]{
+                for(int i=0;i<PLAYERS;i++){
+                    PlayerSpec s=specOf(i);
+                    seen[t][i]=factory.getPlayer(s.name,s.bowling,s.batting);
+                }
+            });
+        }
+        for(auto& th:threads) th.join();
+        bool same=true;
+        for(int t=1;t<8;t++) same=same && seen[t]==seen[0];
+        printf("  race: %d keys requested by 8 threads -> %zu created, %s\n",PLAYERS,factory.created(),
+               same?"all threads got the same flyweights":"MISMATCH");
+    }
+
+    mutex globalMtx;
+    PlayerFactory locked;
+    ConcurrentPlayerFactory sharded;
+    streambuf* old=cout.rdbuf(nullptr); // silence "New object created" during warm-up
+    for(int i=0;i<PLAYERS;i++){
+        PlayerSpec s=specOf(i);
+        locked.getPlayer(s.name,s.bowling,s.batting);
+        sharded.getPlayer(s.name,s.bowling,s.batting);
+    }
+    cout.rdbuf(old);
+
+    auto run=[&](int threadCount,auto lookup){
+        vector<thread> threads;
+        atomic<size_t> sink{0};
+        auto start=chrono::steady_clock::now();
+        for(int t=0;t<threadCount;t++){
+            threads.emplace_back([&,t]{
+                size_t sum=0;
+                unsigned x=t*2654435761u+1;
+                for(int i=0;i<LOOKUPS_PER_THREAD;i++){
+                    x=x*1664525u+1013904223u;
+                    PlayerSpec s=specOf((x>>8)%PLAYERS);
+                    sum+=(size_t)lookup(s);
+                }
+                sink.fetch_add(sum,memory_order_relaxed);
+            });
+        }
+        for(auto& th:threads) th.join();
+        double secs=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+        return (double)threadCount*LOOKUPS_PER_THREAD/secs/1e6;
+    };
+    printf("  %-8s %18s %18s\n","threads","mutex (M/s)","sharded (M/s)");
+    for(int threadCount=1;threadCount<=64;threadCount*=2){
+        double m=run(threadCount,[&](const PlayerSpec& s){
+            lock_guard<mutex> lock(globalMtx);
+            return locked.getPlayer(s.name,s.bowling,s.batting);
+        });
+        double c=run(threadCount,[&](const PlayerSpec& s){ return sharded.getPlayer(s.name,s.bowling,s.batting); });
+        printf("  %-8d %18.2f %18.2f\n",threadCount,m,c);
+    }
+    printf("  (hardware threads: %u)\n",thread::hardware_concurrency());
+}
+
+// Per-match records in today's layout (flyweight pointer + ints) against the
+// handle table and SoA columns, for memory per record and aggregation scans.
+void benchmarkCompactStore(){
+    const int PLAYERS=1000;
+    const size_t RECORDS=10000000;
+    mt19937 rng(22);
+    vector<PlayerSpec> specs;
+    vector<string> names;
+    for(int i=0;i<PLAYERS;i++) names.push_back("Player number "+to_string(i));
+    for(int i=0;i<PLAYERS;i++) specs.push_back({names[i].c_str(),bowlingStyleNames[i%9],battingStyleNames[i%2]});
+
+    struct MatchRecord{ PlayerFlyweight* player; int runs; int wickets; };
+    PlayerFactory factory;
+    vector<PlayerFlyweight*> pointers;
+    PlayerTable table;
+    vector<PlayerHandle> handles;
+    streambuf* old=cout.rdbuf(nullptr); // silence "New object created"
+    pointers.reserve(specs.size());
+    handles.reserve(specs.size());
+    long long factoryAllocs,factoryBytes,tableAllocs;
+    {
+        AllocationCounter counter;
+        for(const PlayerSpec& s:specs) pointers.push_back(factory.getPlayer(s.name,s.bowling,s.batting));
+        factoryAllocs=counter.allocations;
+        factoryBytes=counter.bytes;
+    }
+    cout.rdbuf(old);
+    {
+        AllocationCounter counter;
+        for(const PlayerSpec& s:specs) handles.push_back(table.getPlayer(s.name,s.bowling,s.batting));
+        tableAllocs=counter.allocations;
+    }
+
+    vector<MatchRecord> records;
+    records.reserve(RECORDS);
+    MatchStats stats;
+    stats.reserve(RECORDS);
+    for(size_t i=0;i<RECORDS;i++){
+        int p=rng()%PLAYERS,runs=rng()%120,wickets=rng()%6;
+        records.push_back({pointers[p],runs,wickets});
+        stats.record(handles[p],runs,wickets);
+    }
+
+    printf("  intrinsic, %zu players: PlayerFactory %.1f B/player in %lld allocations, PlayerTable %.1f B/player in %lld\n",
+           factory.size(),(double)factoryBytes/PLAYERS,factoryAllocs,(double)table.bytesUsed()/PLAYERS,tableAllocs);
+    printf("  per-match record: pointer+ints %zu B, SoA columns %zu B\n",sizeof(MatchRecord),MatchStats::bytesPerRecord());
+
+    volatile uint64_t sink=0;
+    auto timeIt=[&](const char* label,auto body){
+        auto start=chrono::steady_clock::now();
+        uint64_t result=body();
+        double secs=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+        sink=sink+result;
+        printf("  %-38s %8.1f M records/s  (checksum %llu)\n",label,RECORDS/secs/1e6,(unsigned long long)result);
+    };
+    timeIt("total runs per player, pointer map",[&]{
+        unordered_map<PlayerFlyweight*,uint64_t> totals;
+        for(const MatchRecord& r:records) totals[r.player]+=r.runs;
+        uint64_t check=0;
+        for(size_t p=0;p<pointers.size();p++) check+=totals[pointers[p]]*(p+1);
+        return check;
+    });
+    timeIt("total runs per player, SoA by handle",[&]{
+        vector<uint64_t> totals=stats.totalRuns(table.size());
+        uint64_t check=0;
+        for(size_t p=0;p<handles.size();p++) check+=totals[handles[p].id]*(p+1);
+        return check;
+    });
+    timeIt("sum of all runs, AoS records",[&]{
+        uint64_t sum=0;
+        for(const MatchRecord& r:records) sum+=r.runs;
+        return sum;
+    });
+    timeIt("sum of all runs, runs column",[&]{ return stats.sumRuns(); });
+}
+
+// Warm start: rebuilding the pool one getPlayer at a time against mapping a snapshot.
+void benchmarkSnapshot(){
+    const int PLAYERS=1000000;
+    const char* path="players.snapshot";
+    vector<string> names;
+    for(int i=0;i<PLAYERS;i++) names.push_back("Player number "+to_string(i));
+    auto bowlingOf=[](int i){ return (BowlingStyle)(i%(int)BowlingStyle::Count); };
+    auto battingOf=[](int i){ return (BattingStyle)(i%(int)BattingStyle::Count); };
+    auto secondsSince=[](chrono::steady_clock::time_point start){
+        return chrono::duration<double>(chrono::steady_clock::now()-start).count();
+    };
+
+    auto start=chrono::steady_clock::now();
+    {
+        PlayerFactory factory;
+        streambuf* old=cout.rdbuf(nullptr); // silence "New object created"
+        for(int i=0;i<PLAYERS;i++){
+            factory.getPlayer(names[i],bowlingStyleNames[(int)bowlingOf(i)],battingStyleNames[(int)battingOf(i)]);
+        }
+        cout.rdbuf(old);
+        printf("  rebuild PlayerFactory, %d players  %9.2f ms\n",PLAYERS,secondsSince(start)*1e3);
+    }
+
+    start=chrono::steady_clock::now();
+    PlayerTable table;
+    for(int i=0;i<PLAYERS;i++) table.getPlayer(names[i],bowlingOf(i),battingOf(i));
+    printf("  rebuild PlayerTable                  %9.2f ms\n",secondsSince(start)*1e3);
+
+    start=chrono::steady_clock::now();
+    table.save(path);
+    printf("  save snapshot                        %9.2f ms\n",secondsSince(start)*1e3);
+
+    const int OPENS=20;
+    size_t mappedBytes=0;
+    for(bool verify:{false,true}){
+        start=chrono::steady_clock::now();
+        for(int i=0;i<OPENS;i++){
+            MappedPlayerTable mapped(path,verify);
+            mappedBytes=mapped.fileBytes();
+        }
+        printf("  mmap load, %-13s (warm cache) %9.4f ms  (%.1f MB file)\n",verify?"verified":"header only",
+               secondsSince(start)*1e3/OPENS,mappedBytes/1e6);
+    }
+
+    // An empty table round-trips; a truncated snapshot is rejected at load.
+    PlayerTable().save(path);
+    printf("  empty snapshot loads with %zu players\n",MappedPlayerTable(path).size());
+    table.save(path);
+    if(truncate(path,(off_t)(mappedBytes/2))==0){
+        try{
+            MappedPlayerTable truncated(path);
+            printf("  truncated snapshot: LOADED\n");
+        }
+        catch(const runtime_error& e){
+            printf("  truncated snapshot rejected: %s\n",e.what());
+        }
+    }
+    table.save(path);
+
+    MappedPlayerTable mapped(path);
+    vector<PlayerHandle> handles(PLAYERS);
+    start=chrono::steady_clock::now();
+    for(int i=0;i<PLAYERS;i++) mapped.findPlayer(names[i],bowlingOf(i),battingOf(i),handles[i]);
+    double lookupSecs=secondsSince(start);
+    int matching=0;
+    for(int i=0;i<PLAYERS;i++) matching+=handles[i]==table.getPlayer(names[i],bowlingOf(i),battingOf(i));
+    printf("  look up every player once, mapped    %9.2f ms  (%d/%d handles match)\n",lookupSecs*1e3,matching,PLAYERS);
+    unlink(path);
+}
+
+// Zipfian lookups (s=0.99) over a churning key space under several memory caps.
+// Each request drops its handle right away except for a window of recent ones
+// that stay pinned, as callers still using a player would.
+void benchmarkBoundedCache(){
+    const int KEYS=200000;
+    const int REQUESTS=2000000;
+    const int PINNED=64;
+    vector<string> names;
+    for(int i=0;i<KEYS;i++) names.push_back("Player number "+to_string(i));
+    vector<double> cdf(KEYS);
+    double total=0;
+    for(int i=0;i<KEYS;i++) cdf[i]=(total+=1.0/pow(i+1,0.99));
+    mt19937_64 rng(24);
+    uniform_real_distribution<double> uniform(0,total);
+    vector<int> requests(REQUESTS);
+    for(int& r:requests) r=(int)(lower_bound(cdf.begin(),cdf.end(),uniform(rng))-cdf.begin());
+
+    size_t fullBytes;
+    {
+        BoundedPlayerCache unbounded(SIZE_MAX);
+        for(int i=0;i<KEYS;i++) unbounded.getPlayer(names[i],bowlingStyleNames[i%9],battingStyleNames[i%2]);
+        fullBytes=unbounded.bytesInUse();
+    }
+    printf("  %d keys, all resident: %.1f MB\n",KEYS,fullBytes/1e6);
+    printf("  %-10s %10s %10s %10s %12s %12s %10s\n","cap","hit rate","misses","evictions","peak MB","resident","ns/get");
+    for(double fraction:{0.01,0.05,0.20,1.0}){
+        BoundedPlayerCache cache((size_t)(fullBytes*fraction));
+        vector<BoundedPlayerCache::PlayerRef> pinned(PINNED);
+        size_t peak=0;
+        volatile size_t sink=0;
+        auto start=chrono::steady_clock::now();
+        for(int i=0;i<REQUESTS;i++){
+            int k=requests[i];
+            BoundedPlayerCache::PlayerRef ref=cache.getPlayer(names[k],bowlingStyleNames[k%9],battingStyleNames[k%2]);
+            sink=sink+ref->getName().size();
+            pinned[i%PINNED]=move(ref);
+            peak=max(peak,cache.bytesInUse());
+        }
+        double secs=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+        char cap[16];
+        snprintf(cap,sizeof(cap),"%.0f%%",fraction*100);
+        printf("  %-10s %10.4f %10lld %10lld %12.2f %12zu %10.1f\n",cap,cache.hitRate(),cache.misses,cache.evictions,
+               peak/1e6,cache.size(),secs*1e9/REQUESTS);
+    }
+}
+
+int main(int argc,char** argv)
 {
     PlayerFactory* pf = new PlayerFactory();
 
@@ -62,6 +1052,19 @@ int main()
     // Reusing existing player object for Virat Kohli
     PlayerFlyweight* third = pf->getPlayer("Virat Kohli","Right arm medium","Right hand");
 
+    if(argc>1 && string(argv[1])=="bench"){
+        cout << "\nPlayerFactory hit path:" << endl;
+        benchmarkLookup();
+        cout << "\nConcurrent PlayerFactory scaling:" << endl;
+        benchmarkConcurrentLookup();
+        cout << "\nCompact handle store and columnar stats:" << endl;
+        benchmarkCompactStore();
+        cout << "\nFlyweight pool snapshot:" << endl;
+        benchmarkSnapshot();
+        cout << "\nBounded flyweight cache:" << endl;
+        benchmarkBoundedCache();
+    }
+
     return 0;
 }
 
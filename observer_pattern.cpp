@@ -1,7 +1,120 @@
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+using namespace std;
+
 typedef long long ll;
+
+// Allocation counting for the benchmarks. Only allocations made on a thread
+// while one of its AllocationCounters is alive are counted, in that counter,
+// so there is no shared counter for concurrent benchmarks to contend on.
+// noinline keeps GCC from pairing the inlined malloc/free against new/delete
+// call sites and warning about a mismatch.
+struct AllocationCounter{
+    ll allocations=0;
+    AllocationCounter* outer;
+    static AllocationCounter*& active(){
+        thread_local AllocationCounter* current=nullptr;
+        return current;
+    }
+    AllocationCounter():outer(active()){ active()=this; }
+    ~AllocationCounter(){ active()=outer; }
+    AllocationCounter(const AllocationCounter&)=delete;
+    AllocationCounter& operator=(const AllocationCounter&)=delete;
+};
+__attribute__((noinline)) void* operator new(size_t n){
+    if(AllocationCounter* counter=AllocationCounter::active()) counter->allocations++;
+    if(void* p=malloc(n?n:1)) return p;
+    throw bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept{
+    free(p);
+}
+__attribute__((noinline)) void operator delete(void* p,size_t) noexcept{
+    free(p);
+}
+
+// Immutable, reference-counted message payload. The header and the bytes share
+// one allocation made when the message is created; copying a Message only
+// bumps the count, so every subscriber of a publish reads the same bytes.
+// A borrowed Message (Message::borrow) instead points at bytes owned elsewhere,
+// such as an EventLog mapping, and neither allocates nor counts references.
+class Message{
+    struct Payload{
+        atomic<uint32_t> refs;
+        size_t size;
+        char* bytes(){
+            return reinterpret_cast<char*>(this+1);
+        }
+    };
+    Payload* payload=nullptr;
+    string_view borrowed; // used only when payload is null
+
+    void release(){
+        if(payload && payload->refs.fetch_sub(1,memory_order_acq_rel)==1){
+            payload->~Payload();
+            ::operator delete(payload);
+        }
+        payload=nullptr;
+    }
+    public:
+    inline static atomic<ll> created{0};
+    inline static atomic<ll> bytesAllocated{0};
+
+    Message()=default;
+    Message(string_view text){
+        void* mem=::operator new(sizeof(Payload)+text.size());
+        payload=new(mem) Payload{{1},text.size()};
+        memcpy(payload->bytes(),text.data(),text.size());
+        created.fetch_add(1,memory_order_relaxed);
+        bytesAllocated.fetch_add(sizeof(Payload)+text.size(),memory_order_relaxed);
+    }
+    Message(const char* text):Message(string_view(text)){}
+    Message(const string& text):Message(string_view(text)){}
+    Message(const Message& other):payload(other.payload),borrowed(other.borrowed){
+        if(payload) payload->refs.fetch_add(1,memory_order_relaxed);
+    }
+    Message(Message&& other) noexcept:payload(other.payload),borrowed(other.borrowed){
+        other.payload=nullptr;
+    }
+    Message& operator=(Message other) noexcept{
+        swap(payload,other.payload);
+        swap(borrowed,other.borrowed);
+        return *this;
+    }
+    // Wraps bytes without copying them. The owner must keep them alive for as
+    // long as any copy of the message; subscribers that keep one longer should
+    // take an owning copy with Message(msg.view()).
+    static Message borrow(string_view bytes){
+        Message m;
+        m.borrowed=bytes;
+        return m;
+    }
+    bool isBorrowed() const{
+        return !payload && borrowed.data();
+    }
+    ~Message(){
+        release();
+    }
+    string_view view() const{
+        return payload?string_view(payload->bytes(),payload->size):borrowed;
+    }
+    const char* data() const{
+        return payload?payload->bytes():borrowed.data()?borrowed.data():"";
+    }
+    size_t size() const{
+        return payload?payload->size:borrowed.size();
+    }
+    uint32_t useCount() const{
+        return payload?payload->refs.load(memory_order_relaxed):0;
+    }
+};
+
 class ISubscriber{
     public:
-    virtual void notify(string msg)=0;
+    virtual void notify(const Message& msg)=0;
+    virtual ~ISubscriber()=default;
 };
 class User: public ISubscriber{
   int id;
@@ -10,55 +123,1534 @@ class User: public ISubscriber{
   User(int id){
       this->id=id;
   }
-  void notify(string msg){
+  void notify(const Message& msg){
       cout<<"This user with id "<<id<<" has been notified"<<endl;
   }
 };
 
+// Returned by Group::subscribe. The generation makes a stale handle (one whose
+// slot has since been reused) harmless to unsubscribe twice.
+struct SubscriptionHandle{
+    uint32_t slot;
+    uint32_t generation;
+};
+
+// Work-stealing pool used for parallel fan-out. Every worker owns a deque of
+// stealable tasks (it pops its own newest task, idle workers steal the oldest
+// task of others) plus a FIFO queue of pinned tasks that only it runs, which
+// is what keeps per-subscriber ordering when deliveries are asynchronous.
+class WorkStealingPool{
+    struct Worker{
+        std::mutex m;
+        deque<function<void()>> local;
+        deque<function<void()>> pinned;
+        atomic<ll> pinnedCount{0};
+    };
+    vector<unique_ptr<Worker>> workers;
+    vector<thread> threads;
+    atomic<ll> stealable{0};
+    atomic<ll> pending{0};
+    atomic<size_t> nextWorker{0};
+    atomic<bool> stop{false};
+    std::mutex sleepMtx;
+    condition_variable wake;
+    condition_variable idle;
+
+    void signal(){
+        { std::lock_guard<std::mutex> lock(sleepMtx); }
+        wake.notify_all();
+    }
+    bool popPinned(size_t i,function<void()>& task){
+        Worker& w=*workers[i];
+        std::lock_guard<std::mutex> lock(w.m);
+        if(w.pinned.empty()) return false;
+        task=std::move(w.pinned.front());
+        w.pinned.pop_front();
+        w.pinnedCount--;
+        return true;
+    }
+    bool popLocal(size_t i,bool newest,function<void()>& task){
+        Worker& w=*workers[i];
+        std::lock_guard<std::mutex> lock(w.m);
+        if(w.local.empty()) return false;
+        if(newest){
+            task=std::move(w.local.back());
+            w.local.pop_back();
+        }
+        else{
+            task=std::move(w.local.front());
+            w.local.pop_front();
+        }
+        stealable--;
+        return true;
+    }
+    // Own newest task first, then steal the oldest task from the others.
+    bool takeStealable(size_t self,function<void()>& task){
+        size_t n=workers.size();
+        if(self<n && popLocal(self,true,task)) return true;
+        for(size_t k=1;k<=n;k++){
+            if(popLocal((self+k)%n,false,task)) return true;
+        }
+        return false;
+    }
+    void finish(){
+        if(--pending==0){
+            { std::lock_guard<std::mutex> lock(sleepMtx); }
+            idle.notify_all();
+        }
+    }
+    void run(size_t i){
+        function<void()> task;
+        while(true){
+            if(popPinned(i,task) || takeStealable(i,task)){
+                task();
+                task=nullptr;
+                finish();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMtx);
+            wake.wait(lock,[&]{ return stop || stealable>0 || workers[i]->pinnedCount>0; });
+            if(stop && stealable==0 && workers[i]->pinnedCount==0) return;
+        }
+    }
+    public:
+    WorkStealingPool(size_t n){
+        for(size_t i=0;i<n;i++) workers.push_back(make_unique<Worker>());
+        for(size_t i=0;i<n;i++) threads.emplace_back([this,i]{ run(i); });
+    }
+    ~WorkStealingPool(){
+        stop=true;
+        signal();
+        for(auto& t:threads) t.join();
+    }
+    size_t size() const{
+        return workers.size();
+    }
+    void submit(function<void()> task){
+        Worker& w=*workers[nextWorker++%workers.size()];
+        pending++;
+        {
+            std::lock_guard<std::mutex> lock(w.m);
+            w.local.push_back(std::move(task));
+            stealable++;
+        }
+        signal();
+    }
+    // Pinned tasks run on `worker` only, in submission order.
+    void submitPinned(size_t worker,function<void()> task){
+        Worker& w=*workers[worker%workers.size()];
+        pending++;
+        {
+            std::lock_guard<std::mutex> lock(w.m);
+            w.pinned.push_back(std::move(task));
+            w.pinnedCount++;
+        }
+        signal();
+    }
+    // Lets a non-pool thread (e.g. a waiting publisher) help with stealable work.
+    bool tryRunOne(){
+        function<void()> task;
+        if(!takeStealable(workers.size(),task)) return false;
+        task();
+        finish();
+        return true;
+    }
+    void waitIdle(){
+        std::unique_lock<std::mutex> lock(sleepMtx);
+        idle.wait(lock,[&]{ return pending==0; });
+    }
+};
+
+struct ParallelNotifyOptions{
+    size_t chunkSize=4096;   // subscribers delivered per task
+    bool wait=true;          // block until every subscriber has been notified
+    bool preserveOrder=true; // async only: a subscriber always sees publishes in order
+};
+
+// Append-only log of published messages, stored as memory-mapped segment
+// files named by their base offset. A record is an 8-byte header (payload
+// length plus one, so that empty payloads are distinguishable from unwritten
+// space) followed by the payload, padded to 8 bytes; its offset is the
+// segment base plus its position. Appenders reserve space with one fetch_add
+// on the segment tail, copy the payload into the mapping and then publish the
+// length with a release store, so concurrent appends never take a lock. The
+// appender whose record straddles the end of a segment writes a PAD marker
+// there and rotates to a new segment. Readers get string_views straight into
+// the mapping, and a zero header marks the live tail.
+class EventLog{
+    static const uint32_t PAD=UINT32_MAX;
+    static const size_t HEADER=8;
+    struct Segment{
+        uint64_t base;
+        size_t capacity;
+        int fd;
+        char* data;
+        atomic<size_t> tail{0};
+    };
+    string dir;
+    size_t segmentBytes;
+    vector<unique_ptr<Segment>> segments;
+    atomic<Segment*> active{nullptr};
+    mutable shared_mutex segmentsMtx;
+
+    static size_t recordSize(size_t payload){
+        return (HEADER+payload+7)&~size_t(7);
+    }
+    static uint32_t lengthAt(const Segment* seg,size_t pos){
+        return atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(seg->data+pos)).load(memory_order_acquire);
+    }
+    string pathFor(uint64_t base) const{
+        char name[32];
+        snprintf(name,sizeof(name),"%020llu.log",(unsigned long long)base);
+        return dir+"/"+name;
+    }
+    Segment* mapSegment(uint64_t base,size_t capacity,bool create){
+        string path=pathFor(base);
+        int fd=open(path.c_str(),create?(O_RDWR|O_CREAT):O_RDWR,0644);
+        if(fd<0) throw runtime_error("EventLog: cannot open "+path);
+        if(create && ftruncate(fd,capacity)!=0){
+            close(fd);
+            throw runtime_error("EventLog: cannot size "+path);
+        }
+        void* mem=mmap(nullptr,capacity,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+        if(mem==MAP_FAILED){
+            close(fd);
+            throw runtime_error("EventLog: cannot map "+path);
+        }
+        auto seg=make_unique<Segment>();
+        seg->base=base;
+        seg->capacity=capacity;
+        seg->fd=fd;
+        seg->data=static_cast<char*>(mem);
+        segments.push_back(std::move(seg));
+        return segments.back().get();
+    }
+    // True if a record with this (non-zero, non-PAD) header ends inside the
+    // segment; anything else is a torn or corrupt write.
+    static bool fits(const Segment* seg,size_t pos,uint32_t header){
+        return pos+recordSize(header-1)<=seg->capacity;
+    }
+    // Walks a reopened segment to find where appends should continue: the
+    // first unwritten or invalid header. Everything after it is zeroed, so a
+    // record committed behind a crashed append can never resurface once the
+    // hole is overwritten.
+    static size_t scanTail(Segment* seg){
+        size_t pos=0;
+        while(pos+HEADER<=seg->capacity){
+            uint32_t header=lengthAt(seg,pos);
+            if(header==PAD) return seg->capacity;
+            if(header==0 || !fits(seg,pos,header)) break;
+            pos+=recordSize(header-1);
+        }
+        if(pos<seg->capacity) memset(seg->data+pos,0,seg->capacity-pos);
+        return pos;
+    }
+    void rotate(Segment* full){
+        unique_lock<shared_mutex> lock(segmentsMtx);
+        if(active.load(memory_order_acquire)!=full) return;
+        Segment* next=mapSegment(full->base+full->capacity,segmentBytes,true);
+        active.store(next,memory_order_release);
+    }
+    Segment* segmentFor(uint64_t offset) const{
+        shared_lock<shared_mutex> lock(segmentsMtx);
+        for(const auto& seg:segments){
+            if(offset>=seg->base && offset<seg->base+seg->capacity) return seg.get();
+        }
+        return nullptr;
+    }
+    public:
+    // Opens (or creates) the log in `dir`, continuing after existing records.
+    EventLog(string dir,size_t segmentBytes=64<<20):dir(dir),segmentBytes((segmentBytes+7)&~size_t(7)){
+        filesystem::create_directories(dir);
+        vector<uint64_t> bases;
+        for(const auto& entry:filesystem::directory_iterator(dir)){
+            if(entry.path().extension()==".log") bases.push_back(stoull(entry.path().stem().string()));
+        }
+        sort(bases.begin(),bases.end());
+        for(uint64_t base:bases){
+            Segment* seg=mapSegment(base,filesystem::file_size(pathFor(base)),false);
+            seg->tail=scanTail(seg);
+        }
+        // Only the last segment takes appends; seal a truncated older one so
+        // replay carries on into the next.
+        for(size_t i=0;i+1<segments.size();i++){
+            Segment* seg=segments[i].get();
+            if(seg->tail<seg->capacity){
+                atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(seg->data+seg->tail)).store(PAD,memory_order_release);
+                seg->tail=seg->capacity;
+            }
+        }
+        if(segments.empty()) mapSegment(0,this->segmentBytes,true);
+        active=segments.back().get();
+    }
+    ~EventLog(){
+        for(auto& seg:segments){
+            munmap(seg->data,seg->capacity);
+            close(seg->fd);
+        }
+    }
+    // Appends one record and returns its offset.
+    uint64_t append(string_view payload){
+        size_t need=recordSize(payload.size());
+        if(payload.size()>=PAD-1 || need>segmentBytes) throw invalid_argument("EventLog: record larger than a segment");
+        while(true){
+            Segment* seg=active.load(memory_order_acquire);
+            size_t pos=seg->tail.fetch_add(need,memory_order_relaxed);
+            if(pos+need<=seg->capacity){
+                memcpy(seg->data+pos+HEADER,payload.data(),payload.size());
+                atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(seg->data+pos)).store(payload.size()+1,memory_order_release);
+                return seg->base+pos;
+            }
+            if(pos<seg->capacity){
+                atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(seg->data+pos)).store(PAD,memory_order_release);
+            }
+            rotate(seg);
+        }
+    }
+    uint64_t append(const Message& msg){
+        return append(msg.view());
+    }
+    // Calls fn(offset, payload) for every committed record from `offset` on;
+    // payload points into the mapping, so nothing is copied. Returns the
+    // offset to resume from next time.
+    uint64_t replay(uint64_t offset,const function<void(uint64_t,string_view)>& fn) const{
+        while(true){
+            Segment* seg=segmentFor(offset);
+            if(!seg) return offset;
+            size_t pos=offset-seg->base;
+            while(pos+HEADER<=seg->capacity){
+                uint32_t header=lengthAt(seg,pos);
+                if(header==PAD) break;
+                if(header==0 || !fits(seg,pos,header)) return seg->base+pos;
+                fn(seg->base+pos,string_view(seg->data+pos+HEADER,header-1));
+                pos+=recordSize(header-1);
+            }
+            offset=seg->base+seg->capacity;
+        }
+    }
+    // Forces mapped pages to disk.
+    void sync(){
+        shared_lock<shared_mutex> lock(segmentsMtx);
+        for(auto& seg:segments) msync(seg->data,seg->capacity,MS_SYNC);
+    }
+    size_t segmentCount() const{
+        shared_lock<shared_mutex> lock(segmentsMtx);
+        return segments.size();
+    }
+};
+
+// Subscribers live in a dense array so notify is a straight scan. Each
+// subscription also owns a slot that records its current dense position;
+// unsubscribe swaps the last subscriber into the hole and patches that
+// subscriber's slot, so both subscribe and unsubscribe are O(1) and never
+// allocate once capacity is reserved. Notification order is therefore not
+// subscription order after an unsubscribe.
 class Group {
+    struct Slot{
+        uint32_t dense;
+        uint32_t generation;
+    };
     vector<ISubscriber*>users;
+    vector<uint32_t>denseToSlot;
+    vector<Slot>slots;
+    vector<uint32_t>freeSlots;
     string name;
+    EventLog* log=nullptr;
     public:
     Group(string name){
         this->name=name;
     }
-    void notify(string msg){
-        for(int i=0;i<users.size();i++){
+    // Durable mode: every published message is appended to `log` before it
+    // is delivered, so late or restarted subscribers can catch up.
+    void enableLog(EventLog* log){
+        this->log=log;
+    }
+    // Delivers the logged messages from `offset` on to one subscriber and
+    // returns the offset to continue from. Each message borrows its bytes from
+    // the log's mapping, which stays valid for the log's lifetime, so replay
+    // neither allocates nor copies.
+    uint64_t replay(ISubscriber* user,uint64_t offset){
+        if(!log) return offset;
+        return log->replay(offset,[&](uint64_t,string_view payload){
+            user->notify(Message::borrow(payload));
+        });
+    }
+    void reserve(size_t n){
+        users.reserve(n);
+        denseToSlot.reserve(n);
+        slots.reserve(n);
+        freeSlots.reserve(n);
+    }
+    size_t size() const{
+        return users.size();
+    }
+    void notify(const Message& msg){
+        if(log) log->append(msg);
+        for(size_t i=0;i<users.size();i++){
             users[i]->notify(msg);
         }
     }
-    void subscribe(ISubscriber* user){
+    // Parallel fan-out over `pool`. With wait=true the subscriber array is
+    // split into chunks that any worker may steal, and the publisher helps
+    // until they are done; blocking also keeps per-subscriber order. With
+    // wait=false the publisher returns immediately: the subscriber list is
+    // snapshotted, and with preserveOrder each subscriber is routed to a fixed
+    // worker's FIFO queue, so later publishes can't overtake earlier ones.
+    void notifyParallel(const Message& msg,WorkStealingPool& pool,ParallelNotifyOptions opts={}){
+        if(log) log->append(msg);
+        size_t chunk=max<size_t>(opts.chunkSize,1);
+        if(opts.wait){
+            size_t chunks=(users.size()+chunk-1)/chunk;
+            atomic<size_t> remaining{chunks};
+            for(size_t begin=0;begin<users.size();begin+=chunk){
+                size_t end=min(users.size(),begin+chunk);
+                pool.submit([this,&msg,&remaining,begin,end]{
+                    for(size_t i=begin;i<end;i++){
+                        users[i]->notify(msg);
+                    }
+                    remaining--;
+                });
+            }
+            while(remaining>0){
+                if(!pool.tryRunOne()) this_thread::yield();
+            }
+            return;
+        }
+        if(!opts.preserveOrder){
+            auto snapshot=make_shared<const vector<ISubscriber*>>(users);
+            for(size_t begin=0;begin<snapshot->size();begin+=chunk){
+                size_t end=min(snapshot->size(),begin+chunk);
+                pool.submit([snapshot,msg,begin,end]{
+                    for(size_t i=begin;i<end;i++){
+                        (*snapshot)[i]->notify(msg);
+                    }
+                });
+            }
+            return;
+        }
+        size_t workers=pool.size();
+        vector<shared_ptr<vector<ISubscriber*>>> buckets(workers);
+        for(auto& b:buckets){
+            b=make_shared<vector<ISubscriber*>>();
+            b->reserve(users.size()/workers+1);
+        }
+        for(ISubscriber* u:users){
+            buckets[orderedWorkerFor(u,workers)]->push_back(u);
+        }
+        for(size_t w=0;w<workers;w++){
+            shared_ptr<const vector<ISubscriber*>> bucket=buckets[w];
+            for(size_t begin=0;begin<bucket->size();begin+=chunk){
+                size_t end=min(bucket->size(),begin+chunk);
+                pool.submitPinned(w,[bucket,msg,begin,end]{
+                    for(size_t i=begin;i<end;i++){
+                        (*bucket)[i]->notify(msg);
+                    }
+                });
+            }
+        }
+    }
+    // Worker that owns a subscriber's ordered deliveries. std::hash of a pointer
+    // is its address, whose low bits are zero for aligned objects, so the
+    // address is shifted and mixed before picking a worker.
+    static size_t orderedWorkerFor(const ISubscriber* user,size_t workers){
+        uint64_t mixed=(uint64_t)((uintptr_t)user>>4)*0x9E3779B97F4A7C15ULL;
+        return (mixed>>32)%workers;
+    }
+    SubscriptionHandle subscribe(ISubscriber* user){
+        uint32_t slot;
+        if(!freeSlots.empty()){
+            slot=freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else{
+            slot=slots.size();
+            slots.push_back({0,0});
+        }
+        slots[slot].dense=users.size();
         users.push_back(user);
+        denseToSlot.push_back(slot);
+        return {slot,slots[slot].generation};
     }
+    // Returns false if the handle was already unsubscribed.
+    bool unsubscribe(SubscriptionHandle h){
+        if(h.slot>=slots.size() || slots[h.slot].generation!=h.generation){
+            return false;
+        }
+        uint32_t pos=slots[h.slot].dense;
+        uint32_t last=users.size()-1;
+        users[pos]=users[last];
+        denseToSlot[pos]=denseToSlot[last];
+        slots[denseToSlot[pos]].dense=pos;
+        users.pop_back();
+        denseToSlot.pop_back();
+        slots[h.slot].generation++;
+        freeSlots.push_back(h.slot);
+        return true;
+    }
+    // Pointer-based removal kept for callers without a handle; this one still
+    // has to search for the subscriber, but it no longer copies the array.
     void unsubscribe(ISubscriber* user){
-        vector<ISubscriber*>temp;
-        for(int i=0;i<users.size();i++){
+        for(size_t i=0;i<users.size();){
             if(users[i]==user){
-                
+                unsubscribe(SubscriptionHandle{denseToSlot[i],slots[denseToSlot[i]].generation});
+            }
+            else{
+                i++;
+            }
+        }
+    }
+};
+
+// Hazard pointers protecting ConcurrentGroup snapshots. Each thread claims a
+// record on first use and publishes the snapshot it is reading; a writer only
+// frees a retired snapshot once no record points at it. A record holds a few
+// slots so a subscriber may itself publish to another ConcurrentGroup.
+class HazardDomain{
+    public:
+    static const int SLOTS_PER_THREAD=4;
+    static const int MAX_THREADS=256;
+    struct Record{
+        atomic<bool> owned{false};
+        atomic<const void*> slots[SLOTS_PER_THREAD];
+        int depth=0;
+    };
+    private:
+    Record records[MAX_THREADS];
+    struct Owner{
+        Record* rec=nullptr;
+        ~Owner(){
+            if(rec) rec->owned.store(false,memory_order_release);
+        }
+    };
+    public:
+    HazardDomain(){
+        for(auto& r:records){
+            for(auto& s:r.slots) s.store(nullptr,memory_order_relaxed);
+        }
+    }
+    static HazardDomain& global(){
+        static HazardDomain domain;
+        return domain;
+    }
+    Record& local(){
+        thread_local Owner owner;
+        if(owner.rec==nullptr){
+            for(auto& r:records){
+                bool expected=false;
+                if(r.owned.compare_exchange_strong(expected,true,memory_order_acquire)){
+                    owner.rec=&r;
+                    break;
+                }
+            }
+            if(owner.rec==nullptr) throw runtime_error("HazardDomain: too many threads");
+        }
+        return *owner.rec;
+    }
+    bool isProtected(const void* p){
+        for(auto& r:records){
+            for(auto& s:r.slots){
+                if(s.load(memory_order_seq_cst)==p) return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Thread-safe Group for concurrent publish and (un)subscribe. The subscriber
+// list is an immutable snapshot behind an atomic pointer: notify protects the
+// current snapshot with a hazard pointer and iterates it without taking any
+// lock, while subscribe/unsubscribe copy the list under a writer mutex and
+// publish the new snapshot. Old snapshots are freed once no reader holds them.
+// A notify that started before an unsubscribe may still reach the removed
+// subscriber; call synchronize() before destroying it.
+class ConcurrentGroup{
+    struct Snapshot{
+        vector<ISubscriber*> users;
+    };
+    atomic<Snapshot*> current;
+    vector<Snapshot*> retired;
+    std::mutex writerMtx;
+    string name;
+
+    Snapshot* acquire(HazardDomain::Record& rec,int slot){
+        Snapshot* p=current.load(memory_order_acquire);
+        while(true){
+            rec.slots[slot].store(p,memory_order_seq_cst);
+            Snapshot* again=current.load(memory_order_seq_cst);
+            if(again==p) return p;
+            p=again;
+        }
+    }
+    // Holds one hazard slot of the calling thread on the current snapshot and
+    // releases it on scope exit, also when a subscriber throws.
+    class ReadGuard{
+        HazardDomain::Record& rec;
+        int slot;
+        public:
+        Snapshot* snap;
+        ReadGuard(ConcurrentGroup& group):rec(HazardDomain::global().local()){
+            if(rec.depth>=HazardDomain::SLOTS_PER_THREAD){
+                throw runtime_error("ConcurrentGroup: notify nested too deeply");
+            }
+            slot=rec.depth++;
+            snap=group.acquire(rec,slot);
+        }
+        ~ReadGuard(){
+            rec.slots[slot].store(nullptr,memory_order_release);
+            rec.depth--;
+        }
+        ReadGuard(const ReadGuard&)=delete;
+        ReadGuard& operator=(const ReadGuard&)=delete;
+    };
+    // Caller holds writerMtx.
+    void publish(Snapshot* next){
+        // seq_cst pairs with the seq_cst hazard store/reload in acquire(): either the
+        // reader sees `next`, or reclaim() below sees the reader's hazard on `old`.
+        Snapshot* old=current.exchange(next,memory_order_seq_cst);
+        retired.push_back(old);
+        reclaim();
+    }
+    void reclaim(){
+        HazardDomain& domain=HazardDomain::global();
+        size_t kept=0;
+        for(Snapshot* s:retired){
+            if(domain.isProtected(s)) retired[kept++]=s;
+            else delete s;
+        }
+        retired.resize(kept);
+    }
+    public:
+    ConcurrentGroup(string name){
+        this->name=name;
+        current.store(new Snapshot(),memory_order_release);
+    }
+    ~ConcurrentGroup(){
+        for(Snapshot* s:retired) delete s;
+        delete current.load();
+    }
+    size_t size(){
+        ReadGuard guard(*this);
+        return guard.snap->users.size();
+    }
+    void notify(const Message& msg){
+        notifyBatch(&msg,1);
+    }
+    // Delivers `count` messages against one snapshot. Each subscriber gets the
+    // whole batch, in order, before the next subscriber is visited.
+    void notifyBatch(const Message* msgs,size_t count){
+        ReadGuard guard(*this);
+        const vector<ISubscriber*>& users=guard.snap->users;
+        for(size_t i=0;i<users.size();i++){
+            for(size_t m=0;m<count;m++){
+                users[i]->notify(msgs[m]);
+            }
+        }
+    }
+    void subscribe(ISubscriber* user){
+        std::lock_guard<std::mutex> lock(writerMtx);
+        Snapshot* next=new Snapshot(*current.load(memory_order_relaxed));
+        next->users.push_back(user);
+        publish(next);
+    }
+    void unsubscribe(ISubscriber* user){
+        std::lock_guard<std::mutex> lock(writerMtx);
+        const Snapshot* cur=current.load(memory_order_relaxed);
+        Snapshot* next=new Snapshot();
+        next->users.reserve(cur->users.size());
+        for(ISubscriber* u:cur->users){
+            if(u!=user) next->users.push_back(u);
+        }
+        publish(next);
+    }
+    // Blocks until every notify that could still see an older snapshot has
+    // finished, after which unsubscribed subscribers may be destroyed.
+    void synchronize(){
+        std::unique_lock<std::mutex> lock(writerMtx);
+        while(!retired.empty()){
+            reclaim();
+            if(retired.empty()) break;
+            lock.unlock();
+            this_thread::yield();
+            lock.lock();
+        }
+    }
+};
+
+// Topic broker for publishing by name across a very large number of groups.
+// Topics are spread over power-of-two shards, each padded to its own cache
+// line and guarded by its own shared_mutex, so publishers on different topics
+// rarely touch the same lock. Inside a shard an open-addressing table stores
+// (hash, topic index) pairs contiguously; lookups take a string_view, compare
+// the cached hash before the name and never allocate. Each topic's subscriber
+// set is a ConcurrentGroup, so delivery happens after the shard lock is
+// released. Topics are never removed, which keeps Topic pointers stable.
+class TopicBroker{
+    struct Topic{
+        string name;
+        ConcurrentGroup group;
+        Topic(string_view name):name(name),group(string(name)){}
+    };
+    struct IndexSlot{
+        uint64_t hash;
+        uint32_t topic; // index into Shard::topics, EMPTY if unused
+    };
+    static const uint32_t EMPTY=UINT32_MAX;
+    struct alignas(64) Shard{
+        mutable shared_mutex mtx;
+        vector<IndexSlot> index;
+        vector<unique_ptr<Topic>> topics;
+    };
+    vector<Shard> shards;
+    size_t shardMask;
+
+    static uint64_t hashOf(string_view topic){
+        return hash<string_view>()(topic);
+    }
+    Shard& shardFor(uint64_t h){
+        return shards[(h>>40)&shardMask];
+    }
+    // Caller holds the shard lock (shared or exclusive).
+    static Topic* find(const Shard& shard,uint64_t h,string_view topic){
+        if(shard.index.empty()) return nullptr;
+        size_t mask=shard.index.size()-1;
+        for(size_t i=h&mask;;i=(i+1)&mask){
+            const IndexSlot& slot=shard.index[i];
+            if(slot.topic==EMPTY) return nullptr;
+            if(slot.hash==h && shard.topics[slot.topic]->name==topic) return shard.topics[slot.topic].get();
+        }
+    }
+    static void insert(Shard& shard,uint64_t h,uint32_t topic){
+        size_t mask=shard.index.size()-1;
+        size_t i=h&mask;
+        while(shard.index[i].topic!=EMPTY) i=(i+1)&mask;
+        shard.index[i]={h,topic};
+    }
+    // Keeps the table at most half full. Caller holds the exclusive lock.
+    static void grow(Shard& shard){
+        if(2*(shard.topics.size()+1)<=shard.index.size()) return;
+        size_t capacity=max<size_t>(16,shard.index.size()*2);
+        vector<IndexSlot> old;
+        old.swap(shard.index);
+        shard.index.assign(capacity,{0,EMPTY});
+        for(const IndexSlot& slot:old){
+            if(slot.topic!=EMPTY) insert(shard,slot.hash,slot.topic);
+        }
+    }
+    Topic* findOrCreate(string_view topic){
+        uint64_t h=hashOf(topic);
+        Shard& shard=shardFor(h);
+        {
+            shared_lock<shared_mutex> lock(shard.mtx);
+            if(Topic* t=find(shard,h,topic)) return t;
+        }
+        unique_lock<shared_mutex> lock(shard.mtx);
+        if(Topic* t=find(shard,h,topic)) return t;
+        grow(shard);
+        shard.topics.push_back(make_unique<Topic>(topic));
+        insert(shard,h,shard.topics.size()-1);
+        return shard.topics.back().get();
+    }
+    public:
+    // `shardCount` is rounded up to a power of two.
+    TopicBroker(size_t shardCount=256):shards(std::bit_ceil(max<size_t>(shardCount,1))){
+        shardMask=shards.size()-1;
+    }
+    void subscribe(string_view topic,ISubscriber* user){
+        findOrCreate(topic)->group.subscribe(user);
+    }
+    void unsubscribe(string_view topic,ISubscriber* user){
+        uint64_t h=hashOf(topic);
+        Shard& shard=shardFor(h);
+        Topic* t;
+        {
+            shared_lock<shared_mutex> lock(shard.mtx);
+            t=find(shard,h,topic);
+        }
+        if(t) t->group.unsubscribe(user);
+    }
+    // Returns false if nobody ever subscribed to `topic`.
+    bool publish(string_view topic,const Message& msg){
+        uint64_t h=hashOf(topic);
+        Shard& shard=shardFor(h);
+        Topic* t;
+        {
+            shared_lock<shared_mutex> lock(shard.mtx);
+            t=find(shard,h,topic);
+        }
+        if(!t) return false;
+        t->group.notify(msg);
+        return true;
+    }
+    size_t topicCount() const{
+        size_t n=0;
+        for(const Shard& shard:shards){
+            shared_lock<shared_mutex> lock(shard.mtx);
+            n+=shard.topics.size();
+        }
+        return n;
+    }
+};
+
+enum class Backpressure{
+    Block,      // wait until the dispatcher frees a slot
+    DropOldest, // evict the oldest queued message to make room
+    FailFast    // reject the publish immediately
+};
+
+struct AsyncQueueOptions{
+    size_t capacity=1024; // rounded up to a power of two
+    size_t maxBatch=64;   // messages handed to subscribers per drain
+    Backpressure policy=Backpressure::Block;
+};
+
+// Asynchronous delivery for a ConcurrentGroup. Publishers push into a bounded
+// lock-free ring (per-cell sequence numbers, as in Vyukov's bounded queue) and
+// return; one dispatcher thread drains up to maxBatch messages at a time and
+// hands them to the group with notifyBatch. Pops are CAS-based so a
+// DropOldest publisher can evict from the head, but otherwise the dispatcher
+// is the only consumer. Sleeping sides park on C++20 atomic waits, and
+// producers only issue a wake-up when the dispatcher is actually asleep.
+class AsyncNotifier{
+    struct Cell{
+        atomic<size_t> seq;
+        Message msg;
+    };
+    struct alignas(64) Metrics{
+        atomic<ll> enqueued{0};
+        atomic<ll> dropped{0};
+        atomic<ll> rejected{0};
+        atomic<ll> batches{0};
+        atomic<ll> delivered{0};
+        atomic<ll> maxBatch{0};
+        atomic<ll> maxDepth{0};
+    };
+    ConcurrentGroup& group;
+    AsyncQueueOptions opts;
+    unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) atomic<size_t> tail{0};
+    alignas(64) atomic<size_t> head{0};
+    alignas(64) atomic<uint32_t> pushed{0};
+    atomic<uint32_t> drained{0};
+    atomic<bool> dispatcherAsleep{false};
+    atomic<bool> stop{false};
+    Metrics metrics;
+    thread dispatcher;
+
+    bool tryPush(const Message& msg){
+        size_t pos=tail.load(memory_order_relaxed);
+        while(true){
+            Cell& c=cells[pos&mask];
+            size_t seq=c.seq.load(memory_order_acquire);
+            intptr_t diff=(intptr_t)seq-(intptr_t)pos;
+            if(diff==0){
+                if(tail.compare_exchange_weak(pos,pos+1,memory_order_relaxed)){
+                    c.msg=msg;
+                    c.seq.store(pos+1,memory_order_release);
+                    return true;
+                }
+            }
+            else if(diff<0){
+                return false;
+            }
+            else{
+                pos=tail.load(memory_order_relaxed);
+            }
+        }
+    }
+    bool tryPop(Message& out){
+        size_t pos=head.load(memory_order_relaxed);
+        while(true){
+            Cell& c=cells[pos&mask];
+            size_t seq=c.seq.load(memory_order_acquire);
+            intptr_t diff=(intptr_t)seq-(intptr_t)(pos+1);
+            if(diff==0){
+                if(head.compare_exchange_weak(pos,pos+1,memory_order_relaxed)){
+                    out=std::move(c.msg);
+                    c.msg=Message();
+                    c.seq.store(pos+mask+1,memory_order_release);
+                    return true;
+                }
+            }
+            else if(diff<0){
+                return false;
             }
             else{
-                temp.push_back(users[i]);
+                pos=head.load(memory_order_relaxed);
+            }
+        }
+    }
+    static void raise(atomic<ll>& high,ll value){
+        ll cur=high.load(memory_order_relaxed);
+        while(value>cur && !high.compare_exchange_weak(cur,value,memory_order_relaxed)){}
+    }
+    void wakeDispatcher(){
+        pushed.fetch_add(1,memory_order_seq_cst);
+        if(dispatcherAsleep.load(memory_order_seq_cst)) pushed.notify_one();
+    }
+    void run(){
+        vector<Message> batch(opts.maxBatch);
+        while(true){
+            uint32_t seen=pushed.load(memory_order_seq_cst);
+            size_t n=0;
+            while(n<opts.maxBatch && tryPop(batch[n])) n++;
+            if(n>0){
+                drained.fetch_add(1,memory_order_release);
+                drained.notify_all();
+                group.notifyBatch(batch.data(),n);
+                for(size_t i=0;i<n;i++) batch[i]=Message();
+                metrics.batches.fetch_add(1,memory_order_relaxed);
+                metrics.delivered.fetch_add(n,memory_order_relaxed);
+                raise(metrics.maxBatch,n);
+                continue;
+            }
+            if(stop.load(memory_order_acquire)) return;
+            dispatcherAsleep.store(true,memory_order_seq_cst);
+            if(depth()==0 && !stop.load(memory_order_seq_cst)) pushed.wait(seen);
+            dispatcherAsleep.store(false,memory_order_relaxed);
+        }
+    }
+    public:
+    AsyncNotifier(ConcurrentGroup& group,AsyncQueueOptions options={}):group(group),opts(options){
+        opts.capacity=std::bit_ceil(max<size_t>(opts.capacity,2));
+        opts.maxBatch=max<size_t>(opts.maxBatch,1);
+        mask=opts.capacity-1;
+        cells.reset(new Cell[opts.capacity]);
+        for(size_t i=0;i<opts.capacity;i++) cells[i].seq.store(i,memory_order_relaxed);
+        dispatcher=thread([this]{ run(); });
+    }
+    // Drains whatever is still queued before returning.
+    ~AsyncNotifier(){
+        stop.store(true,memory_order_seq_cst);
+        pushed.fetch_add(1);
+        pushed.notify_one();
+        dispatcher.join();
+    }
+    // Returns false only when the FailFast policy rejected the message.
+    bool publish(const Message& msg){
+        while(!tryPush(msg)){
+            if(opts.policy==Backpressure::FailFast){
+                metrics.rejected.fetch_add(1,memory_order_relaxed);
+                return false;
+            }
+            if(opts.policy==Backpressure::DropOldest){
+                Message evicted;
+                if(tryPop(evicted)) metrics.dropped.fetch_add(1,memory_order_relaxed);
+                continue;
+            }
+            uint32_t seen=drained.load(memory_order_acquire);
+            if(depth()<opts.capacity) continue;
+            drained.wait(seen);
+        }
+        metrics.enqueued.fetch_add(1,memory_order_relaxed);
+        raise(metrics.maxDepth,depth());
+        wakeDispatcher();
+        return true;
+    }
+    size_t depth() const{
+        size_t t=tail.load(memory_order_acquire);
+        size_t h=head.load(memory_order_acquire);
+        return t>h?t-h:0;
+    }
+    // Blocks until everything published so far has been delivered.
+    void flush(){
+        while(metrics.delivered.load()+metrics.dropped.load()<metrics.enqueued.load()){
+            this_thread::yield();
+        }
+    }
+    void printMetrics() const{
+        ll batches=metrics.batches;
+        cout<<"  queue depth now="<<depth()<<" max="<<metrics.maxDepth
+            <<" | enqueued="<<metrics.enqueued<<" dropped="<<metrics.dropped<<" rejected="<<metrics.rejected
+            <<" | batches="<<batches<<" avg batch="<<(batches?(double)metrics.delivered/batches:0.0)
+            <<" max batch="<<metrics.maxBatch<<endl;
+    }
+};
+
+// Subscriber used by the benchmarks: counts deliveries without printing.
+class CountingSubscriber: public ISubscriber{
+  public:
+  atomic<ll> received{0}; // several publisher threads may notify the same subscriber
+  void notify(const Message&){
+      received.fetch_add(1,memory_order_relaxed);
+  }
+};
+
+// The copy-on-unsubscribe loop the Group used to have, kept for comparison.
+void legacyUnsubscribe(vector<ISubscriber*>& users,ISubscriber* user){
+    vector<ISubscriber*>temp;
+    for(size_t i=0;i<users.size();i++){
+        if(users[i]!=user){
+            temp.push_back(users[i]);
+        }
+    }
+    users=temp;
+}
+
+void benchmarkChurn(){
+    const int N=1000000;
+    const int CHURN=2000000;
+    vector<CountingSubscriber> subs(N+CHURN);
+    mt19937 rng(42);
+    using clk=chrono::steady_clock;
+
+    Group g("bench");
+    g.reserve(N);
+    vector<SubscriptionHandle> handles;
+    handles.reserve(N);
+    auto t0=clk::now();
+    for(int i=0;i<N;i++) handles.push_back(g.subscribe(&subs[i]));
+    auto t1=clk::now();
+    // Each churn step drops a random live subscription and adds a new one.
+    for(int i=0;i<CHURN;i++){
+        size_t k=rng()%handles.size();
+        g.unsubscribe(handles[k]);
+        handles[k]=g.subscribe(&subs[N+i]);
+    }
+    auto t2=clk::now();
+    g.notify("ping");
+    auto t3=clk::now();
+
+    auto ns=[](clk::duration d){ return (double)chrono::duration_cast<chrono::nanoseconds>(d).count(); };
+    cout<<"handle Group, "<<N<<" subscribers"<<endl;
+    cout<<"  subscribe:        "<<ns(t1-t0)/N<<" ns/op"<<endl;
+    cout<<"  churn (unsub+sub):"<<ns(t2-t1)/CHURN<<" ns/op"<<endl;
+    cout<<"  notify all:       "<<ns(t3-t2)/1e6<<" ms"<<endl;
+
+    // The old path is O(n) per unsubscribe, so only a handful of ops are timed.
+    vector<ISubscriber*> legacy;
+    for(int i=0;i<N;i++) legacy.push_back(&subs[i]);
+    const int LEGACY_OPS=20;
+    auto t4=clk::now();
+    for(int i=0;i<LEGACY_OPS;i++){
+        legacyUnsubscribe(legacy,&subs[rng()%N]);
+        legacy.push_back(&subs[N+i]);
+    }
+    auto t5=clk::now();
+    cout<<"copying unsubscribe, "<<N<<" subscribers"<<endl;
+    cout<<"  churn (unsub+sub):"<<ns(t5-t4)/LEGACY_OPS<<" ns/op"<<endl;
+}
+
+// Subscriber that burns a fixed amount of CPU per message, standing in for a
+// handler that does real work.
+class BusySubscriber: public ISubscriber{
+  int spin;
+  public:
+  atomic<ll> received{0};
+  BusySubscriber(int spin=200):spin(spin){}
+  void notify(const Message&){
+      volatile ll x=0;
+      for(int i=0;i<spin;i++) x=x+i;
+      received.fetch_add(1,memory_order_relaxed);
+  }
+};
+
+// Records the last sequence number seen to check per-subscriber ordering.
+class OrderedSubscriber: public ISubscriber{
+  public:
+  ll last=-1;
+  ll outOfOrder=0;
+  void notify(const Message& msg){
+      ll seq=stoll(string(msg.view()));
+      if(seq<last) outOfOrder++;
+      last=seq;
+  }
+};
+
+void benchmarkParallelNotify(){
+    const int N=200000;
+    const int PUBLISHES=10;
+    vector<BusySubscriber> subs(N);
+    Group g("fanout");
+    g.reserve(N);
+    for(auto& s:subs) g.subscribe(&s);
+    size_t threads=max(2u,thread::hardware_concurrency());
+    WorkStealingPool pool(threads);
+    using clk=chrono::steady_clock;
+    auto ms=[](clk::duration d){ return chrono::duration<double,milli>(d).count(); };
+
+    cout<<"fan-out to "<<N<<" subscribers, "<<threads<<" pool threads"<<endl;
+    cout<<"mode                    latency/publish(ms)  deliveries/s"<<endl;
+    auto report=[&](const string& mode,double publishMs,double totalMs){
+        cout<<left<<setw(24)<<mode<<right<<setw(19)<<publishMs/PUBLISHES
+            <<setw(14)<<(ll)(1000.0*N*PUBLISHES/totalMs)<<endl;
+    };
+    auto t0=clk::now();
+    for(int p=0;p<PUBLISHES;p++) g.notify("m");
+    double serial=ms(clk::now()-t0);
+    report("serial",serial,serial);
+    for(size_t chunk:{256,4096,65536}){
+        ParallelNotifyOptions o;
+        o.chunkSize=chunk;
+        auto t1=clk::now();
+        for(int p=0;p<PUBLISHES;p++) g.notifyParallel("m",pool,o);
+        double d=ms(clk::now()-t1);
+        report("parallel chunk="+to_string(chunk),d,d);
+    }
+    for(bool ordered:{false,true}){
+        ParallelNotifyOptions o;
+        o.wait=false;
+        o.preserveOrder=ordered;
+        auto t1=clk::now();
+        for(int p=0;p<PUBLISHES;p++) g.notifyParallel("m",pool,o);
+        double publish=ms(clk::now()-t1);
+        pool.waitIdle();
+        report(ordered?"async ordered":"async unordered",publish,ms(clk::now()-t1));
+    }
+
+    // Ordered mode pins each subscriber to one worker; the busiest worker should
+    // own close to 1/threads of them.
+    vector<size_t> perWorker(threads,0);
+    for(auto& s:subs) perWorker[Group::orderedWorkerFor(&s,threads)]++;
+    streamsize oldPrecision=cout.precision(3);
+    cout<<"async ordered busiest worker share: "<<fixed
+        <<(double)*max_element(perWorker.begin(),perWorker.end())/N<<defaultfloat<<endl;
+    cout.precision(oldPrecision);
+
+    // Ordering check: async ordered delivery of consecutive sequence numbers.
+    vector<OrderedSubscriber> ordered(1000);
+    Group og("ordered");
+    for(auto& s:ordered) og.subscribe(&s);
+    ParallelNotifyOptions o;
+    o.wait=false;
+    o.chunkSize=64;
+    for(int seq=0;seq<200;seq++) og.notifyParallel(to_string(seq),pool,o);
+    pool.waitIdle();
+    ll bad=0;
+    for(auto& s:ordered) bad+=s.outOfOrder+(s.last!=199);
+    cout<<"async ordered delivery violations: "<<bad<<endl;
+}
+
+// Subscriber for the concurrent stress test: fails loudly if it is notified
+// after it has been unsubscribed, synchronized and marked dead.
+class LivenessSubscriber: public ISubscriber{
+  public:
+  atomic<ll> received{0};
+  atomic<bool> alive{true};
+  atomic<ll>* violations;
+  LivenessSubscriber(atomic<ll>* violations):violations(violations){}
+  void notify(const Message&){
+      if(!alive.load(memory_order_acquire)) (*violations)++;
+      received.fetch_add(1,memory_order_relaxed);
+  }
+};
+
+// Publishers and mutators hammer one ConcurrentGroup. Permanent subscribers
+// must see every publish exactly once, and churned subscribers must never be
+// notified after synchronize() returned.
+void stressConcurrentGroup(){
+    const int PUBLISHERS=4,MUTATORS=2,PUBLISHES=20000,PERMANENT=8;
+    atomic<ll> violations{0};
+    ConcurrentGroup g("stress");
+    vector<unique_ptr<LivenessSubscriber>> permanent;
+    for(int i=0;i<PERMANENT;i++){
+        permanent.push_back(make_unique<LivenessSubscriber>(&violations));
+        g.subscribe(permanent.back().get());
+    }
+    atomic<bool> stop{false};
+    vector<thread> threads;
+    for(int m=0;m<MUTATORS;m++){
+        threads.emplace_back([&]{
+            while(!stop){
+                auto s=make_unique<LivenessSubscriber>(&violations);
+                g.subscribe(s.get());
+                this_thread::yield();
+                g.unsubscribe(s.get());
+                g.synchronize();
+                s->alive=false;
+                this_thread::yield();
             }
+        });
+    }
+    vector<thread> publishers;
+    for(int p=0;p<PUBLISHERS;p++){
+        publishers.emplace_back([&]{
+            for(int i=0;i<PUBLISHES;i++) g.notify("stress");
+        });
+    }
+    for(auto& t:publishers) t.join();
+    stop=true;
+    for(auto& t:threads) t.join();
+    ll missing=0;
+    for(auto& s:permanent) missing+=PUBLISHERS*PUBLISHES-s->received;
+    cout<<"ConcurrentGroup stress: missing deliveries="<<missing<<" use-after-unsubscribe="<<violations<<endl;
+}
+
+// Concurrent publishers and mutators: lock-free snapshot reads versus a
+// Group guarded by one mutex.
+void benchmarkConcurrentGroup(){
+    const int SUBSCRIBERS=1000;
+    vector<CountingSubscriber> base(SUBSCRIBERS);
+    auto run=[&](const string& label,int publishers,int mutators,auto notify,auto mutate){
+        atomic<bool> stop{false};
+        atomic<ll> publishes{0},mutations{0};
+        vector<thread> threads;
+        for(int p=0;p<publishers;p++){
+            threads.emplace_back([&]{
+                ll n=0;
+                while(!stop){ notify(); n++; }
+                publishes+=n;
+            });
+        }
+        for(int m=0;m<mutators;m++){
+            threads.emplace_back([&]{
+                ll n=0;
+                CountingSubscriber extra;
+                while(!stop){ mutate(&extra); n++; this_thread::sleep_for(chrono::microseconds(50)); }
+                mutations+=n;
+            });
         }
-        users=temp;
+        this_thread::sleep_for(chrono::milliseconds(300));
+        stop=true;
+        for(auto& t:threads) t.join();
+        cout<<left<<setw(14)<<label<<right<<setw(11)<<publishers<<setw(9)<<mutators
+            <<setw(14)<<(ll)(publishes/0.3)<<setw(14)<<(ll)(mutations/0.3)<<endl;
+    };
+    cout<<"variant        publishers mutators  publishes/s  mutations/s"<<endl;
+    for(int publishers:{1,4,8}){
+        ConcurrentGroup cg("rcu");
+        for(auto& s:base) cg.subscribe(&s);
+        run("rcu snapshot",publishers,2,
+            [&]{ cg.notify("m"); },
+            [&](ISubscriber* s){ cg.subscribe(s); cg.unsubscribe(s); cg.synchronize(); });
+
+        Group g("mutex");
+        std::mutex m;
+        for(auto& s:base) g.subscribe(&s);
+        run("mutex Group",publishers,2,
+            [&]{ std::lock_guard<std::mutex> lock(m); g.notify("m"); },
+            [&](ISubscriber* s){
+                SubscriptionHandle h;
+                { std::lock_guard<std::mutex> lock(m); h=g.subscribe(s); }
+                { std::lock_guard<std::mutex> lock(m); g.unsubscribe(h); }
+            });
     }
 }
-int main()
+
+// Subscriber interface as it was before Message: the payload is taken by
+// value, so every delivery copies it. Kept for the payload benchmark.
+class IStringSubscriber{
+    public:
+    virtual void notify(string msg)=0;
+    virtual ~IStringSubscriber()=default;
+};
+class StringReader: public IStringSubscriber{
+  public:
+  ll bytes=0;
+  void notify(string msg){
+      bytes+=msg[msg.size()/2];
+  }
+};
+class MessageReader: public ISubscriber{
+  public:
+  ll bytes=0;
+  void notify(const Message& msg){
+      bytes+=msg.data()[msg.size()/2];
+  }
+};
+
+void benchmarkMessagePayload(){
+    const int SUBSCRIBERS=1000;
+    const int PUBLISHES=200;
+    using clk=chrono::steady_clock;
+    cout<<"payload   path      allocs/publish  bytes-copied/publish  publishes/s"<<endl;
+    for(size_t payload:{64,4096,65536}){
+        string text(payload,'x');
+
+        vector<StringReader> legacySubs(SUBSCRIBERS);
+        vector<IStringSubscriber*> legacy;
+        for(auto& s:legacySubs) legacy.push_back(&s);
+        AllocationCounter legacyAllocs;
+        auto t0=clk::now();
+        for(int p=0;p<PUBLISHES;p++){
+            string msg=text;
+            for(auto* s:legacy) s->notify(msg);
+        }
+        double secs=chrono::duration<double>(clk::now()-t0).count();
+        ll allocs=legacyAllocs.allocations;
+        cout<<setw(7)<<payload<<"   string  "<<setw(16)<<(double)allocs/PUBLISHES
+            <<setw(22)<<(ll)payload*(SUBSCRIBERS+1)<<setw(13)<<(ll)(PUBLISHES/secs)<<endl;
+
+        vector<MessageReader> subs(SUBSCRIBERS);
+        Group g("payload");
+        g.reserve(SUBSCRIBERS);
+        for(auto& s:subs) g.subscribe(&s);
+        ll created=Message::created;
+        AllocationCounter messageAllocs;
+        t0=clk::now();
+        for(int p=0;p<PUBLISHES;p++){
+            g.notify(Message(text));
+        }
+        secs=chrono::duration<double>(clk::now()-t0).count();
+        cout<<setw(7)<<payload<<"   Message "<<setw(16)<<(double)messageAllocs.allocations/PUBLISHES
+            <<setw(22)<<(ll)payload*(Message::created-created)/PUBLISHES<<setw(13)<<(ll)(PUBLISHES/secs)<<endl;
+    }
+}
+
+// Publish throughput by topic name: the sharded broker against a single
+// mutex-guarded unordered_map<string,Group*> that builds a key per lookup.
+void benchmarkTopicBroker(){
+    const int TOPICS=1000000;
+    const int OPS_PER_THREAD=500000;
+    vector<string> names(TOPICS);
+    for(int i=0;i<TOPICS;i++) names[i]="orders/region-"+to_string(i%97)+"/shop-"+to_string(i);
+    atomic<ll> delivered{0};
+    class Tally: public ISubscriber{
+      atomic<ll>* n;
+      public:
+      Tally(atomic<ll>* n):n(n){}
+      void notify(const Message&){ n->fetch_add(1,memory_order_relaxed); }
+    } tally(&delivered);
+
+    using clk=chrono::steady_clock;
+    TopicBroker broker;
+    auto t0=clk::now();
+    for(const string& n:names) broker.subscribe(n,&tally);
+    cout<<"TopicBroker: "<<broker.topicCount()<<" topics indexed in "
+        <<chrono::duration<double,milli>(clk::now()-t0).count()<<" ms"<<endl;
+
+    std::mutex globalMtx;
+    unordered_map<string,Group*> global;
+    vector<unique_ptr<Group>> groups;
+    for(const string& n:names){
+        groups.push_back(make_unique<Group>(n));
+        groups.back()->subscribe(&tally);
+        global[n]=groups.back().get();
+    }
+
+    Message msg("tick");
+    auto run=[&](const string& label,int threads,auto publish){
+        atomic<ll> allocs{0};
+        vector<thread> workers;
+        auto begin=clk::now();
+        for(int t=0;t<threads;t++){
+            workers.emplace_back([&,t]{
+                AllocationCounter counter;
+                mt19937 rng(t+1);
+                for(int i=0;i<OPS_PER_THREAD;i++){
+                    publish(string_view(names[rng()%TOPICS]));
+                }
+                allocs.fetch_add(counter.allocations,memory_order_relaxed);
+            });
+        }
+        for(auto& w:workers) w.join();
+        double secs=chrono::duration<double>(clk::now()-begin).count();
+        cout<<left<<setw(18)<<label<<right<<setw(8)<<threads<<setw(15)<<(ll)(threads*OPS_PER_THREAD/secs)
+            <<setw(17)<<(double)allocs.load()/(threads*OPS_PER_THREAD)<<endl;
+    };
+    cout<<"index             threads  publishes/s  allocs/publish"<<endl;
+    for(int threads:{1,2,4,8}){
+        run("sharded broker",threads,[&](string_view topic){ broker.publish(topic,msg); });
+        run("global map+mutex",threads,[&](string_view topic){
+            std::lock_guard<std::mutex> lock(globalMtx);
+            auto it=global.find(string(topic));
+            if(it!=global.end()) it->second->notify(msg);
+        });
+    }
+}
+
+// Producer-side latency of AsyncNotifier under each backpressure policy,
+// with a subscriber that is slower than the publishers.
+void benchmarkAsyncNotifier(){
+    const int PRODUCERS=4,PER_PRODUCER=50000;
+    ConcurrentGroup g("async");
+    BusySubscriber slow(400);
+    g.subscribe(&slow);
+    Message msg("event");
+    using clk=chrono::steady_clock;
+    cout<<"policy       p50(ns)  p99(ns)  max(ns)  publishes/s"<<endl;
+    for(Backpressure policy:{Backpressure::Block,Backpressure::DropOldest,Backpressure::FailFast}){
+        string label=policy==Backpressure::Block?"block":policy==Backpressure::DropOldest?"drop-oldest":"fail-fast";
+        AsyncQueueOptions o;
+        o.capacity=4096;
+        o.maxBatch=128;
+        o.policy=policy;
+        AsyncNotifier notifier(g,o);
+        vector<vector<ll>> samples(PRODUCERS);
+        vector<thread> producers;
+        auto begin=clk::now();
+        for(int p=0;p<PRODUCERS;p++){
+            producers.emplace_back([&,p]{
+                samples[p].reserve(PER_PRODUCER);
+                for(int i=0;i<PER_PRODUCER;i++){
+                    auto t0=clk::now();
+                    notifier.publish(msg);
+                    samples[p].push_back(chrono::duration_cast<chrono::nanoseconds>(clk::now()-t0).count());
+                }
+            });
+        }
+        for(auto& t:producers) t.join();
+        double secs=chrono::duration<double>(clk::now()-begin).count();
+        vector<ll> all;
+        for(auto& v:samples) all.insert(all.end(),v.begin(),v.end());
+        sort(all.begin(),all.end());
+        cout<<left<<setw(12)<<label<<right<<setw(9)<<all[all.size()/2]<<setw(9)<<all[all.size()*99/100]
+            <<setw(9)<<all.back()<<setw(13)<<(ll)(all.size()/secs)<<endl;
+        notifier.flush();
+        notifier.printMetrics();
+    }
+}
+
+// Append and replay rates of EventLog with small segments so rotation is
+// part of the measurement.
+void benchmarkEventLog(){
+    string dir=(filesystem::temp_directory_path()/"observer_event_log_bench").string();
+    using clk=chrono::steady_clock;
+    cout<<"payload  threads  appends/s    MB/s  replay rec/s  replay MB/s  segments"<<endl;
+    for(size_t payload:{64,1024}){
+        for(int threads:{1,4}){
+            filesystem::remove_all(dir);
+            const int PER_THREAD=1000000/threads*(payload>64?1:2)/2;
+            string text(payload,'e');
+            EventLog log(dir,16<<20);
+            auto t0=clk::now();
+            vector<thread> writers;
+            for(int t=0;t<threads;t++){
+                writers.emplace_back([&]{
+                    for(int i=0;i<PER_THREAD;i++) log.append(string_view(text));
+                });
+            }
+            for(auto& w:writers) w.join();
+            double appendSecs=chrono::duration<double>(clk::now()-t0).count();
+            ll records=0,bytes=0;
+            auto t1=clk::now();
+            log.replay(0,[&](uint64_t,string_view p){ records++; bytes+=p.size(); });
+            double replaySecs=chrono::duration<double>(clk::now()-t1).count();
+            ll total=(ll)threads*PER_THREAD;
+            cout<<setw(7)<<payload<<setw(9)<<threads<<setw(11)<<(ll)(total/appendSecs)
+                <<setw(8)<<(ll)(total*payload/appendSecs/1e6)<<setw(14)<<(ll)(records/replaySecs)
+                <<setw(13)<<(ll)(bytes/replaySecs/1e6)<<setw(10)<<log.segmentCount()
+                <<(records==total?"":"  MISSING RECORDS")<<endl;
+        }
+    }
+    filesystem::remove_all(dir);
+}
+
+int main(int argc,char** argv)
 {
     Group* group=new Group("temp");
     User* user1=new User(1);
     User* user2=new User(2);
     User* user3=new User(3);
     group->subscribe(user1);
-    group->subscribe(user2);
+    SubscriptionHandle h2=group->subscribe(user2);
     group->subscribe(user3);
-    
-    group->notify();
-    group->unsubscribe(user2);
-    
-    group->notify();
-    
-    
+
+    group->notify("hello");
+    group->unsubscribe(h2);
+
+    group->notify("hello again");
+
+    WorkStealingPool pool(2);
+    group->notifyParallel("hello in parallel",pool);
+
+    ConcurrentGroup* shared=new ConcurrentGroup("shared");
+    shared->subscribe(user1);
+    shared->subscribe(user2);
+    thread publisher([&]{ shared->notify("from another thread"); });
+    publisher.join();
+    shared->unsubscribe(user1);
+    shared->synchronize();
+    shared->notify("after unsubscribe");
+    {
+        // A throwing subscriber must not leave its hazard slot behind.
+        struct Failing: public ISubscriber{
+            void notify(const Message&){ throw runtime_error("subscriber failed"); }
+        } failing;
+        ConcurrentGroup fragile("fragile");
+        fragile.subscribe(&failing);
+        for(int i=0;i<HazardDomain::SLOTS_PER_THREAD+2;i++){
+            try{ fragile.notify("boom"); }catch(const runtime_error&){}
+        }
+        fragile.unsubscribe(&failing);
+        fragile.synchronize();
+        cout<<"throwing subscriber released its hazard slots"<<endl;
+    }
+
+    TopicBroker broker;
+    broker.subscribe("sports/cricket",user1);
+    broker.subscribe("sports/cricket",user3);
+    broker.subscribe("news",user2);
+    broker.publish("sports/cricket","score update");
+
+    {
+        AsyncNotifier async(*shared);
+        async.publish("queued for the dispatcher");
+        async.flush();
+    }
+
+    string logDir=(filesystem::temp_directory_path()/"observer_event_log_demo").string();
+    filesystem::remove_all(logDir);
+    {
+        EventLog log(logDir);
+        Group durable("durable");
+        durable.enableLog(&log);
+        durable.subscribe(user1);
+        durable.notify("first");
+        durable.notify("second");
+        // user3 joins late and catches up from the start of the log
+        uint64_t next=durable.replay(user3,0);
+        durable.subscribe(user3);
+        cout<<"late subscriber caught up to offset "<<next<<endl;
+    }
+    filesystem::remove_all(logDir);
+    {
+        // Empty payloads survive a round-trip and a reopen of the log.
+        auto contents=[&](EventLog& log){
+            string joined;
+            log.replay(0,[&](uint64_t,string_view p){ joined+="["+string(p)+"]"; });
+            return joined;
+        };
+        {
+            EventLog log(logDir);
+            for(const char* p:{"a","","b","c"}) log.append(string_view(p));
+            cout<<"event log: "<<contents(log);
+        }
+        EventLog reopened(logDir);
+        reopened.append(string_view("d"));
+        ll createdBefore=Message::created.load();
+        MessageReader reader;
+        Group catchUp("catch-up");
+        catchUp.enableLog(&reopened);
+        catchUp.replay(&reader,0);
+        cout<<", after reopen: "<<contents(reopened)<<", messages allocated by replay: "
+            <<Message::created.load()-createdBefore<<endl;
+    }
+    filesystem::remove_all(logDir);
+    {
+        // A crash can leave a corrupt header with a committed record behind
+        // it; reopening truncates at the bad header instead of trusting it.
+        size_t tail;
+        {
+            EventLog log(logDir);
+            for(const char* p:{"a","b"}) log.append(string_view(p));
+            tail=log.append(string_view("c"))+16;
+        }
+        int fd=open((logDir+"/00000000000000000000.log").c_str(),O_RDWR);
+        uint32_t corrupt=0x7fffffff,stale=2;
+        bool written=pwrite(fd,&corrupt,sizeof(corrupt),tail)==sizeof(corrupt)
+                  && pwrite(fd,&stale,sizeof(stale),tail+16)==sizeof(stale)
+                  && pwrite(fd,"x",1,tail+24)==1;
+        close(fd);
+        EventLog reopened(logDir);
+        reopened.append(string_view("d"));
+        string joined;
+        reopened.replay(0,[&](uint64_t,string_view p){ joined+="["+string(p)+"]"; });
+        cout<<"event log after a torn write"<<(written?"":" (simulation failed)")<<": "<<joined<<endl;
+    }
+    filesystem::remove_all(logDir);
+
+    // Run "./observer_pattern bench" for the stress test and benchmarks
+    if(argc>1 && string(argv[1])=="bench"){
+        benchmarkChurn();
+        benchmarkParallelNotify();
+        stressConcurrentGroup();
+        benchmarkConcurrentGroup();
+        benchmarkMessagePayload();
+        benchmarkTopicBroker();
+        benchmarkAsyncNotifier();
+        benchmarkEventLog();
+    }
 
     return 0;
 }
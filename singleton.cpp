@@ -2,6 +2,7 @@
 #include<mutex>
 using namespace std;
 
+// Classic singleton: every call takes the mutex, even after the instance exists.
 class Singleton{
 Singleton(){
     cout<<"private constructor created"<<endl;
@@ -25,8 +26,440 @@ static Singleton* getInstance(){
 
 Singleton* Singleton::instance=nullptr;
 std::mutex Singleton::mtx;
-int main()
+
+// Double-checked locking: once the instance is published, getInstance is a
+// single acquire-load. The mutex is only taken while the instance is missing.
+class FastSingleton{
+FastSingleton(){
+    cout<<"private constructor created"<<endl;
+}
+FastSingleton(const FastSingleton&)=delete;
+FastSingleton& operator=(const FastSingleton&)=delete;
+static std::atomic<FastSingleton*> instance;
+static std::mutex mtx;
+public:
+
+static FastSingleton* getInstance(){
+    FastSingleton* p=instance.load(std::memory_order_acquire);
+    if(p==nullptr){
+        std::lock_guard<std::mutex> lock(mtx);
+        p=instance.load(std::memory_order_relaxed);
+        if(p==nullptr){
+            p=new FastSingleton();
+            instance.store(p,std::memory_order_release);
+            cout<<"new instance created"<<endl;
+        }
+    }
+    return p;
+}
+};
+
+std::atomic<FastSingleton*> FastSingleton::instance{nullptr};
+std::mutex FastSingleton::mtx;
+
+// Meyers singleton: the compiler guards the function-local static, and after
+// the first call the check is a single load of the guard variable.
+class LocalStaticSingleton{
+LocalStaticSingleton(){
+    cout<<"private constructor created"<<endl;
+}
+LocalStaticSingleton(const LocalStaticSingleton&)=delete;
+LocalStaticSingleton& operator=(const LocalStaticSingleton&)=delete;
+public:
+
+static LocalStaticSingleton* getInstance(){
+    static LocalStaticSingleton instance;
+    return &instance;
+}
+};
+
+// Hot-reloadable singleton guarded by a seqlock. Readers copy the current
+// value without locking and retry if a writer was active during the copy; a
+// writer bumps the sequence to odd, stores the new value and bumps it back to
+// even. The payload is kept in atomic words so a torn copy is never UB, only
+// retried. T must be trivially copyable (plain config structs).
+template<typename T>
+class ReloadableSingleton{
+static_assert(std::is_trivially_copyable<T>::value,"ReloadableSingleton needs a trivially copyable T");
+static constexpr size_t WORDS=(sizeof(T)+sizeof(uint64_t)-1)/sizeof(uint64_t);
+std::atomic<uint64_t> seq{0};
+std::atomic<uint64_t> words[WORDS];
+std::mutex writerMtx;
+
+ReloadableSingleton(){
+    publish(T{});
+}
+ReloadableSingleton(const ReloadableSingleton&)=delete;
+ReloadableSingleton& operator=(const ReloadableSingleton&)=delete;
+public:
+
+static ReloadableSingleton* getInstance(){
+    static ReloadableSingleton instance;
+    return &instance;
+}
+
+// Returns a consistent snapshot; `version` receives the number of publishes
+// that produced it.
+T read(uint64_t* version=nullptr) const{
+    uint64_t buf[WORDS];
+    uint64_t before,after;
+    do{
+        before=seq.load(std::memory_order_acquire);
+        while(before&1){
+            before=seq.load(std::memory_order_acquire);
+        }
+        for(size_t i=0;i<WORDS;i++){
+            buf[i]=words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after=seq.load(std::memory_order_relaxed);
+    }while(before!=after);
+    if(version) *version=before/2;
+    T value;
+    memcpy(&value,buf,sizeof(T));
+    return value;
+}
+
+// Publishes a new instance. Writers serialize among themselves only.
+void publish(const T& value){
+    uint64_t buf[WORDS]={};
+    memcpy(buf,&value,sizeof(T));
+    std::lock_guard<std::mutex> lock(writerMtx);
+    uint64_t s=seq.load(std::memory_order_relaxed);
+    seq.store(s+1,std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for(size_t i=0;i<WORDS;i++){
+        words[i].store(buf[i],std::memory_order_relaxed);
+    }
+    seq.store(s+2,std::memory_order_release);
+}
+
+uint64_t version() const{
+    return seq.load(std::memory_order_acquire)/2;
+}
+};
+
+// Example hot config. Every field is derived from `generation` so a torn
+// snapshot is easy to detect in the benchmark.
+struct AppConfig{
+    int generation;
+    int maxConnections;
+    int timeoutMs;
+    char region[20];
+};
+
+AppConfig makeConfig(int generation){
+    AppConfig c{};
+    c.generation=generation;
+    c.maxConnections=generation*2;
+    c.timeoutMs=generation*3;
+    snprintf(c.region,sizeof(c.region),"region-%d",generation%1000);
+    return c;
+}
+
+bool isConsistent(const AppConfig& c){
+    char expected[20];
+    snprintf(expected,sizeof(expected),"region-%d",c.generation%1000);
+    return c.maxConnections==c.generation*2 && c.timeoutMs==c.generation*3 && strcmp(c.region,expected)==0;
+}
+
+// Registry that owns named singletons and their startup order. Each entry
+// declares the entries it depends on (which must already be registered, so
+// the graph can never contain a cycle). Entries are created either lazily by
+// get<T>() or eagerly by startAll(), which initializes independent entries
+// in parallel on a small thread pool. Every entry is built exactly once and
+// its init time is recorded for report().
+class SingletonRegistry{
+struct Entry{
+    string name;
+    vector<int> deps;
+    vector<int> dependents;
+    function<shared_ptr<void>()> factory;
+    std::once_flag once;
+    shared_ptr<void> instance;
+    chrono::microseconds initTime{0};
+};
+vector<unique_ptr<Entry>> entries;
+unordered_map<string,int> index;
+mutable std::mutex mtx;
+
+Entry* find(const string& name) const{
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it=index.find(name);
+    if(it==index.end()){
+        throw std::out_of_range("unknown singleton: "+name);
+    }
+    return entries[it->second].get();
+}
+
+void ensure(Entry* e){
+    std::call_once(e->once,[&]{
+        for(int d:e->deps){
+            ensure(entries[d].get());
+        }
+        auto begin=chrono::steady_clock::now();
+        e->instance=e->factory();
+        e->initTime=chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now()-begin);
+    });
+}
+
+public:
+SingletonRegistry()=default;
+SingletonRegistry(const SingletonRegistry&)=delete;
+SingletonRegistry& operator=(const SingletonRegistry&)=delete;
+
+static SingletonRegistry* getInstance(){
+    static SingletonRegistry instance;
+    return &instance;
+}
+
+// Registration is expected to happen before startAll()/get() are used.
+template<typename T>
+void registerSingleton(const string& name,const vector<string>& deps,function<T*()> factory){
+    std::lock_guard<std::mutex> lock(mtx);
+    if(index.count(name)){
+        throw std::invalid_argument("singleton already registered: "+name);
+    }
+    auto e=make_unique<Entry>();
+    e->name=name;
+    int id=entries.size();
+    // Resolve every dependency before touching other entries, so a failed
+    // registration leaves the registry unchanged.
+    for(const string& d:deps){
+        auto it=index.find(d);
+        if(it==index.end()){
+            throw std::invalid_argument(name+" depends on unregistered singleton "+d);
+        }
+        e->deps.push_back(it->second);
+    }
+    for(int dep:e->deps) entries[dep]->dependents.push_back(id);
+    e->factory=[factory]{ return shared_ptr<void>(factory(),[](void* p){ delete static_cast<T*>(p); }); };
+    index[name]=id;
+    entries.push_back(std::move(e));
+}
+
+// Lazy access: builds the entry (and its dependencies) on first use.
+template<typename T>
+T* get(const string& name){
+    Entry* e=find(name);
+    ensure(e);
+    return static_cast<T*>(e->instance.get());
+}
+
+// Eager startup: entries whose dependencies are done are handed to `threads`
+// workers, so independent chains initialize concurrently. The first factory
+// exception stops the startup and is rethrown here.
+void startAll(int threads){
+    int n=entries.size();
+    vector<int> pending(n);
+    std::queue<int> ready;
+    for(int i=0;i<n;i++){
+        pending[i]=entries[i]->deps.size();
+        if(pending[i]==0) ready.push(i);
+    }
+    std::mutex qmtx;
+    std::condition_variable cv;
+    int done=0;
+    std::exception_ptr failure;
+    vector<thread> pool;
+    for(int t=0;t<threads;t++){
+        pool.emplace_back([&]{
+            while(true){
+                int id;
+                {
+                    std::unique_lock<std::mutex> lock(qmtx);
+                    cv.wait(lock,[&]{ return !ready.empty() || done==n || failure; });
+                    if(ready.empty() || failure) return;
+                    id=ready.front();
+                    ready.pop();
+                }
+                try{
+                    ensure(entries[id].get());
+                }catch(...){
+                    std::lock_guard<std::mutex> lock(qmtx);
+                    if(!failure) failure=std::current_exception();
+                    cv.notify_all();
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(qmtx);
+                done++;
+                for(int next:entries[id]->dependents){
+                    if(--pending[next]==0) ready.push(next);
+                }
+                cv.notify_all();
+            }
+        });
+    }
+    for(auto& t:pool) t.join();
+    if(failure) std::rethrow_exception(failure);
+}
+
+void report() const{
+    std::lock_guard<std::mutex> lock(mtx);
+    for(const auto& e:entries){
+        cout<<"  "<<left<<setw(12)<<e->name<<right;
+        if(e->instance) cout<<setw(8)<<e->initTime.count()/1000.0<<" ms"<<endl;
+        else cout<<"  not initialized"<<endl;
+    }
+}
+};
+
+// Runs getInstance from `threads` threads for `duration` and returns calls/sec.
+template<typename GetInstance>
+double measureCallsPerSec(GetInstance getInstance,int threads,chrono::milliseconds duration){
+    atomic<bool> start{false},stop{false};
+    atomic<long long> total{0};
+    vector<thread> workers;
+    for(int t=0;t<threads;t++){
+        workers.emplace_back([&]{
+            while(!start.load(memory_order_acquire)){}
+            long long calls=0;
+            uintptr_t sink=0;
+            while(!stop.load(memory_order_relaxed)){
+                for(int i=0;i<1024;i++){
+                    sink^=reinterpret_cast<uintptr_t>(getInstance());
+                }
+                calls+=1024;
+            }
+            total+=calls+(sink==1);
+        });
+    }
+    auto begin=chrono::steady_clock::now();
+    start.store(true,memory_order_release);
+    this_thread::sleep_for(duration);
+    stop.store(true);
+    for(auto& w:workers) w.join();
+    double secs=chrono::duration<double>(chrono::steady_clock::now()-begin).count();
+    return total.load()/secs;
+}
+
+void benchmarkGetInstance(){
+    cout<<"threads  mutex(calls/s)  dcl(calls/s)  local-static(calls/s)"<<endl;
+    for(int threads=1;threads<=64;threads*=2){
+        auto d=chrono::milliseconds(200);
+        double m=measureCallsPerSec([]{return Singleton::getInstance();},threads,d);
+        double a=measureCallsPerSec([]{return FastSingleton::getInstance();},threads,d);
+        double s=measureCallsPerSec([]{return LocalStaticSingleton::getInstance();},threads,d);
+        cout<<setw(7)<<threads<<setw(16)<<(long long)m<<setw(14)<<(long long)a<<setw(23)<<(long long)s<<endl;
+    }
+}
+
+// Read-heavy benchmark: reader throughput with no writer, then with a writer
+// reloading the config at roughly `reloadsPerSec`.
+void benchmarkReload(){
+    auto* cfg=ReloadableSingleton<AppConfig>::getInstance();
+    cfg->publish(makeConfig(1));
+    auto run=[&](int readers,int reloadsPerSec){
+        atomic<bool> stop{false};
+        atomic<long long> reads{0},torn{0};
+        atomic<int> reloads{0};
+        vector<thread> workers;
+        for(int t=0;t<readers;t++){
+            workers.emplace_back([&]{
+                long long n=0,bad=0;
+                while(!stop.load(memory_order_relaxed)){
+                    AppConfig c=cfg->read();
+                    if(!isConsistent(c)) bad++;
+                    n++;
+                }
+                reads+=n;
+                torn+=bad;
+            });
+        }
+        thread writer;
+        if(reloadsPerSec>0){
+            writer=thread([&]{
+                auto period=chrono::nanoseconds(1000000000LL/reloadsPerSec);
+                int gen=2;
+                while(!stop.load(memory_order_relaxed)){
+                    cfg->publish(makeConfig(gen++));
+                    reloads++;
+                    this_thread::sleep_for(period);
+                }
+            });
+        }
+        auto begin=chrono::steady_clock::now();
+        this_thread::sleep_for(chrono::milliseconds(300));
+        stop=true;
+        for(auto& w:workers) w.join();
+        if(writer.joinable()) writer.join();
+        double secs=chrono::duration<double>(chrono::steady_clock::now()-begin).count();
+        cout<<setw(8)<<readers<<setw(13)<<reloadsPerSec<<setw(16)<<(long long)(reads/secs)
+            <<setw(10)<<reloads.load()<<setw(7)<<torn.load()<<endl;
+    };
+    cout<<"readers  reloads/s  reads/s(total)  reloads  torn"<<endl;
+    for(int readers:{1,4,16,64}){
+        run(readers,0);
+        run(readers,1000);
+        run(readers,100000);
+    }
+}
+
+// Example services for the registry demo; each sleeps to mimic slow setup.
+struct ServiceStub{
+    string name;
+    ServiceStub(string name,int setupMs):name(name){
+        this_thread::sleep_for(chrono::milliseconds(setupMs));
+    }
+};
+
+void registerServices(SingletonRegistry& r){
+    r.registerSingleton<ServiceStub>("Config",{},[]{ return new ServiceStub("Config",20); });
+    r.registerSingleton<ServiceStub>("Logger",{"Config"},[]{ return new ServiceStub("Logger",30); });
+    r.registerSingleton<ServiceStub>("Metrics",{"Config"},[]{ return new ServiceStub("Metrics",40); });
+    r.registerSingleton<ServiceStub>("Cache",{"Config"},[]{ return new ServiceStub("Cache",50); });
+    r.registerSingleton<ServiceStub>("Database",{"Config","Logger"},[]{ return new ServiceStub("Database",60); });
+    r.registerSingleton<ServiceStub>("Api",{"Database","Cache","Metrics"},[]{ return new ServiceStub("Api",10); });
+}
+
+void demoRegistry(){
+    for(int threads:{1,4}){
+        SingletonRegistry r;
+        registerServices(r);
+        auto begin=chrono::steady_clock::now();
+        r.startAll(threads);
+        auto ms=chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now()-begin).count();
+        cout<<"startAll("<<threads<<") cold start: "<<ms<<" ms"<<endl;
+        r.report();
+    }
+    // Lazy mode only builds what the requested entry needs.
+    SingletonRegistry lazy;
+    registerServices(lazy);
+    ServiceStub* db=lazy.get<ServiceStub>("Database");
+    cout<<"lazy get("<<db->name<<"):"<<endl;
+    lazy.report();
+
+    // A rejected registration must leave the registry startable.
+    SingletonRegistry partial;
+    registerServices(partial);
+    try{
+        partial.registerSingleton<ServiceStub>("Search",{"Config","Index"},[]{ return new ServiceStub("Search",10); });
+    }catch(const std::invalid_argument& ex){
+        cout<<"rejected: "<<ex.what()<<endl;
+    }
+    partial.startAll(4);
+    cout<<"startAll(4) after rejected registration: ok"<<endl;
+}
+
+int main(int argc,char** argv)
 {
     Singleton* c=Singleton::getInstance();
     Singleton* d=Singleton::getInstance();
+
+    [[maybe_unused]] FastSingleton* e=FastSingleton::getInstance();
+    [[maybe_unused]] FastSingleton* f=FastSingleton::getInstance();
+
+    auto* config=ReloadableSingleton<AppConfig>::getInstance();
+    config->publish(makeConfig(7));
+    uint64_t version=0;
+    AppConfig snapshot=config->read(&version);
+    cout<<"config v"<<version<<" region="<<snapshot.region<<" timeoutMs="<<snapshot.timeoutMs<<endl;
+
+    demoRegistry();
+
+    // Run "./singleton bench" for the getInstance and reload benchmarks
+    if(argc>1 && string(argv[1])=="bench"){
+        benchmarkGetInstance();
+        benchmarkReload();
+    }
 }
@@ -1,21 +1,46 @@
 #include <bits/stdc++.h>
 #include<mutex>
+#include<coroutine>
 using namespace std;
 
 class PaymentStrategy{
   public:
   virtual void pay()=0;
+  // Pays for `n` strategies that all have this object's dynamic type.
+  // The default just calls pay() on each; BatchPayment overrides it with a
+  // non-virtual loop.
+  virtual void payBatch(PaymentStrategy* const* same,size_t n){
+      for(size_t i=0;i<n;i++){
+          same[i]->pay();
+      }
+  }
+  virtual ~PaymentStrategy()=default;
+};
+
+// CRTP base for batch-aware strategies: payBatch casts every entry to the
+// concrete type and calls Derived::pay() directly, so the loop has no
+// indirect branch and the body can be inlined. Derived must be final:
+// a subclass overriding pay() would otherwise be paid as Derived.
+template<typename Derived>
+class BatchPayment : public PaymentStrategy{
+  public:
+  void payBatch(PaymentStrategy* const* same,size_t n) override{
+      static_assert(is_final_v<Derived>,"BatchPayment<Derived> requires Derived to be final");
+      for(size_t i=0;i<n;i++){
+          static_cast<Derived*>(same[i])->Derived::pay();
+      }
+  }
 };
 
-class CreditCardPayment : public PaymentStrategy{
+class CreditCardPayment final : public BatchPayment<CreditCardPayment>{
   public:
   void pay(){
       cout<<"paying this thorugh credit card"<<endl;
   }
-    
+
 };
 
-class UpiPayment : public PaymentStrategy{
+class UpiPayment final : public BatchPayment<UpiPayment>{
     public:
     void pay(){
         cout<<"paying thorugh upi"<<endl;
@@ -28,16 +53,680 @@ class Checkout{
   void setPaymentStrategy(PaymentStrategy* strategy){
       this->strategy=strategy;
   }
-  
+  PaymentStrategy* getPaymentStrategy(){
+      return strategy;
+  }
+
   void proceedToPay(){
       strategy->pay();
   }
 };
-int main()
+
+// Closed-set alternative to Checkout: when every strategy is known at build
+// time, the strategy lives inline in a std::variant and proceedToPay goes
+// through std::visit. No heap allocation, no pointer to chase, and each
+// alternative's pay() is called qualified, so it is a direct call the
+// compiler can inline even though the alternatives are PaymentStrategies.
+// Checkout with a PaymentStrategy* stays the open path for plugin strategies.
+// A checkout with no strategy set throws instead of picking one.
+template<typename... Strategies>
+class VariantCheckout{
+  variant<monostate,Strategies...> strategy;
+  public:
+  template<typename S>
+  void setPaymentStrategy(S s){
+      strategy=std::move(s);
+  }
+
+  void proceedToPay(){
+      std::visit([](auto& s){
+          using S=decay_t<decltype(s)>;
+          if constexpr(is_same_v<S,monostate>) throw logic_error("VariantCheckout: no payment strategy set");
+          else s.S::pay();
+      },strategy);
+  }
+};
+
+using ClosedCheckout=VariantCheckout<CreditCardPayment,UpiPayment>;
+
+// ---- Asynchronous checkout (C++20 coroutines) ----
+// A real payment mostly waits on the gateway. proceedToPayAsync() suspends
+// at that wait instead of blocking, so one EventLoop thread can keep
+// thousands of payments in flight.
+
+// Lazily started coroutine returning T (non-void). Awaiting it starts the
+// body and resumes the awaiter when it finishes (symmetric transfer, so
+// long chains of awaits don't grow the stack).
+template<typename T>
+class Task{
+  public:
+  struct promise_type{
+      T value{};
+      coroutine_handle<> continuation=noop_coroutine();
+      Task get_return_object(){ return Task(coroutine_handle<promise_type>::from_promise(*this)); }
+      suspend_always initial_suspend() noexcept{ return {}; }
+      struct FinalAwaiter{
+          bool await_ready() noexcept{ return false; }
+          coroutine_handle<> await_suspend(coroutine_handle<promise_type> h) noexcept{ return h.promise().continuation; }
+          void await_resume() noexcept{}
+      };
+      FinalAwaiter final_suspend() noexcept{ return {}; }
+      void return_value(T v){ value=std::move(v); }
+      void unhandled_exception(){ terminate(); }
+  };
+  Task(Task&& other) noexcept:handle(exchange(other.handle,nullptr)){}
+  Task& operator=(Task&&)=delete;
+  ~Task(){ if(handle) handle.destroy(); }
+
+  bool await_ready() const noexcept{ return false; }
+  coroutine_handle<> await_suspend(coroutine_handle<> awaiting) noexcept{
+      handle.promise().continuation=awaiting;
+      return handle;
+  }
+  T await_resume(){ return std::move(handle.promise().value); }
+
+  private:
+  explicit Task(coroutine_handle<promise_type> h):handle(h){}
+  coroutine_handle<promise_type> handle;
+};
+
+// Coroutine started by EventLoop::spawn to drive a Task; frees itself at the end.
+struct Detached{
+  struct promise_type{
+      Detached get_return_object(){ return Detached{coroutine_handle<promise_type>::from_promise(*this)}; }
+      suspend_always initial_suspend() noexcept{ return {}; }
+      suspend_never final_suspend() noexcept{ return {}; }
+      void return_void(){}
+      void unhandled_exception(){ terminate(); }
+  };
+  coroutine_handle<promise_type> handle;
+};
+
+// Single-threaded scheduler: a ready queue of coroutines plus a timer heap.
+// spawn() may be called from any thread; coroutines always run on the loop
+// thread. Run one loop per thread to use a few cores.
+class EventLoop{
+  typedef chrono::steady_clock clk;
+  struct Timer{
+      clk::time_point deadline;
+      coroutine_handle<> handle;
+      bool operator>(const Timer& other) const{ return deadline>other.deadline; }
+  };
+  std::mutex mtx;
+  condition_variable wake;
+  deque<coroutine_handle<>> ready;
+  priority_queue<Timer,vector<Timer>,greater<Timer>> timers;
+  size_t live=0; // spawned tasks that have not finished yet
+  bool stopping=false;
+
+  template<typename T>
+  static Detached drive(EventLoop& loop,Task<T> task){
+      co_await task;
+      {
+          lock_guard<std::mutex> lock(loop.mtx);
+          loop.live--;
+      }
+      // the task may have finished on another loop's thread; let run() see live==0
+      loop.wake.notify_all();
+  }
+
+  public:
+  // Starts `task` on this loop; its result is discarded.
+  template<typename T>
+  void spawn(Task<T> task){
+      Detached d=drive(*this,std::move(task));
+      {
+          lock_guard<std::mutex> lock(mtx);
+          ready.push_back(d.handle);
+          live++;
+      }
+      wake.notify_one();
+  }
+  // May be called from any thread. The loop is woken when the new timer
+  // becomes the earliest, since it may be sleeping until a later deadline
+  // (or with no deadline at all).
+  void schedule(coroutine_handle<> h,clk::time_point deadline){
+      bool earliest;
+      {
+          lock_guard<std::mutex> lock(mtx);
+          earliest=timers.empty() || deadline<timers.top().deadline;
+          timers.push({deadline,h});
+      }
+      if(earliest) wake.notify_one();
+  }
+  // Awaitable that resumes the coroutine on this loop after `d`.
+  auto sleepFor(clk::duration d){
+      struct Awaiter{
+          EventLoop& loop;
+          clk::time_point deadline;
+          bool await_ready() const noexcept{ return false; }
+          void await_suspend(coroutine_handle<> h){ loop.schedule(h,deadline); }
+          void await_resume() const noexcept{}
+      };
+      return Awaiter{*this,clk::now()+d};
+  }
+  // Runs until stop() was called and every spawned task has finished.
+  void run(){
+      vector<coroutine_handle<>> batch;
+      while(true){
+          {
+              unique_lock<std::mutex> lock(mtx);
+              while(true){
+                  auto now=clk::now();
+                  while(!timers.empty() && timers.top().deadline<=now){
+                      ready.push_back(timers.top().handle);
+                      timers.pop();
+                  }
+                  if(!ready.empty()) break;
+                  if(stopping && live==0) return;
+                  if(timers.empty()) wake.wait(lock);
+                  else wake.wait_until(lock,timers.top().deadline);
+              }
+              batch.assign(ready.begin(),ready.end());
+              ready.clear();
+          }
+          for(coroutine_handle<> h:batch) h.resume();
+      }
+  }
+  void stop(){
+      {
+          lock_guard<std::mutex> lock(mtx);
+          stopping=true;
+      }
+      wake.notify_all();
+  }
+};
+
+// Local stand-in for a payment gateway: each charge waits a simulated
+// network latency (a base delay plus a rare slow tail) on the event loop,
+// and fails with probability failureRate.
+class StubGateway{
+  chrono::microseconds base;
+  chrono::microseconds slowTail;
+  double slowFraction;
+  double failureRate;
+  static double uniform(){
+      thread_local mt19937 rng(random_device{}());
+      return uniform_real_distribution<double>(0,1)(rng);
+  }
+  public:
+  atomic<long long> charges{0};
+  StubGateway(chrono::microseconds base,chrono::microseconds slowTail,double slowFraction,double failureRate=0)
+      :base(base),slowTail(slowTail),slowFraction(slowFraction),failureRate(failureRate){}
+  chrono::microseconds nextLatency(){
+      auto jitter=chrono::microseconds((long long)(base.count()*0.2*uniform()));
+      return base+jitter+(uniform()<slowFraction?slowTail:chrono::microseconds(0));
+  }
+  Task<bool> charge(EventLoop& loop){
+      co_await loop.sleepFor(nextLatency());
+      charges++;
+      co_return uniform()>=failureRate;
+  }
+};
+
+class AsyncPaymentStrategy{
+  public:
+  virtual Task<bool> payAsync(EventLoop& loop)=0;
+  virtual ~AsyncPaymentStrategy()=default;
+};
+
+class AsyncCreditCardPayment : public AsyncPaymentStrategy{
+  StubGateway& gateway;
+  public:
+  AsyncCreditCardPayment(StubGateway& gateway):gateway(gateway){}
+  Task<bool> payAsync(EventLoop& loop) override{
+      co_return co_await gateway.charge(loop);
+  }
+};
+
+class AsyncUpiPayment : public AsyncPaymentStrategy{
+  StubGateway& gateway;
+  public:
+  AsyncUpiPayment(StubGateway& gateway):gateway(gateway){}
+  Task<bool> payAsync(EventLoop& loop) override{
+      co_return co_await gateway.charge(loop);
+  }
+};
+
+class AsyncCheckout{
+  AsyncPaymentStrategy* strategy;
+  public:
+  void setPaymentStrategy(AsyncPaymentStrategy* strategy){
+      this->strategy=strategy;
+  }
+  Task<bool> proceedToPayAsync(EventLoop& loop){
+      return strategy->payAsync(loop);
+  }
+};
+
+// Latency/failure statistics for one route, updated lock-free from any
+// loop thread: EWMAs via CAS on atomic<double>, plus a log2 histogram of
+// latencies in microseconds for percentiles.
+class RouteStats{
+  static const int BUCKETS=32; // bucket b holds latencies in [2^(b-1), 2^b) us
+  atomic<double> latencyEwmaUs;
+  atomic<double> failureEwma{0};
+  atomic<long long> histogram[BUCKETS];
+  atomic<long long> calls{0};
+  atomic<long long> failures{0};
+  double alpha;
+
+  static void blend(atomic<double>& ewma,double sample,double alpha){
+      double cur=ewma.load(memory_order_relaxed);
+      while(!ewma.compare_exchange_weak(cur,cur+alpha*(sample-cur),memory_order_relaxed)){}
+  }
+  public:
+  atomic<int> inFlight{0};
+
+  RouteStats(double alpha=0.05,double initialLatencyUs=1000):latencyEwmaUs(initialLatencyUs),alpha(alpha){
+      for(auto& b:histogram) b.store(0,memory_order_relaxed);
+  }
+  void record(chrono::microseconds latency,bool ok){
+      long long us=max<long long>(latency.count(),0);
+      blend(latencyEwmaUs,(double)us,alpha);
+      blend(failureEwma,ok?0.0:1.0,alpha);
+      histogram[min<int>(bit_width((unsigned long long)us),BUCKETS-1)].fetch_add(1,memory_order_relaxed);
+      calls.fetch_add(1,memory_order_relaxed);
+      if(!ok) failures.fetch_add(1,memory_order_relaxed);
+  }
+  double latencyUs() const{ return latencyEwmaUs.load(memory_order_relaxed); }
+  double failureRate() const{ return failureEwma.load(memory_order_relaxed); }
+  long long callCount() const{ return calls.load(memory_order_relaxed); }
+  long long failureCount() const{ return failures.load(memory_order_relaxed); }
+  // Upper bound of the bucket holding the p-th percentile (p in [0,1]).
+  long long percentileUs(double p) const{
+      long long total=0;
+      for(auto& b:histogram) total+=b.load(memory_order_relaxed);
+      long long target=(long long)ceil(p*total),seen=0;
+      for(int b=0;b<BUCKETS;b++){
+          seen+=histogram[b].load(memory_order_relaxed);
+          if(seen>=target && seen>0) return 1LL<<b;
+      }
+      return 0;
+  }
+};
+
+// Picks a payment strategy per checkout instead of having one set by hand.
+// Each payment goes to the healthy route (failure EWMA under the threshold)
+// with the lowest latency EWMA; a small share is sent to a random route so
+// the estimates of the others stay fresh and a recovered route is noticed.
+// If no route is healthy, the one failing least is used. The router is an
+// AsyncPaymentStrategy itself, so AsyncCheckout takes it like any other.
+class AdaptivePaymentRouter : public AsyncPaymentStrategy{
+  struct Route{
+      string name;
+      AsyncPaymentStrategy* strategy;
+      unique_ptr<RouteStats> stats;
+  };
+  vector<Route> routes;
+  double maxFailureRate;
+  double explore;
+
+  static double uniform(){
+      thread_local mt19937 rng(random_device{}());
+      return uniform_real_distribution<double>(0,1)(rng);
+  }
+  size_t pick(){
+      if(routes.size()>1 && uniform()<explore) return (size_t)(uniform()*routes.size())%routes.size();
+      size_t best=routes.size();
+      for(size_t i=0;i<routes.size();i++){
+          const RouteStats& st=*routes[i].stats;
+          if(st.failureRate()>maxFailureRate) continue;
+          if(best==routes.size() || st.latencyUs()<routes[best].stats->latencyUs()) best=i;
+      }
+      if(best<routes.size()) return best;
+      best=0;
+      for(size_t i=1;i<routes.size();i++){
+          if(routes[i].stats->failureRate()<routes[best].stats->failureRate()) best=i;
+      }
+      return best;
+  }
+  public:
+  AdaptivePaymentRouter(double maxFailureRate=0.2,double explore=0.02)
+      :maxFailureRate(maxFailureRate),explore(explore){}
+  // Register every route before the first payment.
+  void addRoute(string name,AsyncPaymentStrategy* strategy){
+      routes.push_back({name,strategy,make_unique<RouteStats>()});
+  }
+  Task<bool> payAsync(EventLoop& loop) override{
+      if(routes.empty()) co_return false;
+      Route& route=routes[pick()];
+      route.stats->inFlight++;
+      auto start=chrono::steady_clock::now();
+      bool ok=co_await route.strategy->payAsync(loop);
+      route.stats->record(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now()-start),ok);
+      route.stats->inFlight--;
+      co_return ok;
+  }
+  // Exported metrics, one line per route.
+  void printMetrics() const{
+      long long total=0;
+      for(const Route& r:routes) total+=r.stats->callCount();
+      for(const Route& r:routes){
+          const RouteStats& st=*r.stats;
+          printf("  %-10s calls=%-7lld share=%5.1f%% ewma=%7.0fus fail=%5.1f%% p50<=%lldus p99<=%lldus\n",
+                 r.name.c_str(),st.callCount(),total?100.0*st.callCount()/total:0.0,st.latencyUs(),100*st.failureRate(),
+                 st.percentileUs(0.5),st.percentileUs(0.99));
+      }
+  }
+};
+
+// Collects pending checkouts and pays them bucketed by strategy type, so
+// each bucket runs as one tight loop through the strategy's payBatch
+// instead of alternating virtual calls across types.
+class BatchCheckout{
+  struct Bucket{
+      const type_info* type;
+      vector<PaymentStrategy*> strategies;
+  };
+  vector<Bucket> buckets; // a handful of strategy types, linear search is fastest
+  size_t pendingCount=0;
+  public:
+  void add(Checkout* checkout){
+      PaymentStrategy* s=checkout->getPaymentStrategy();
+      const type_info* type=&typeid(*s);
+      Bucket* bucket=nullptr;
+      for(Bucket& b:buckets){
+          if(b.type==type){
+              bucket=&b;
+              break;
+          }
+      }
+      // Same type can have distinct type_info objects across shared libraries
+      for(size_t i=0;bucket==nullptr && i<buckets.size();i++){
+          if(*buckets[i].type==*type) bucket=&buckets[i];
+      }
+      if(bucket==nullptr){
+          buckets.push_back({type,{}});
+          bucket=&buckets.back();
+      }
+      bucket->strategies.push_back(s);
+      pendingCount++;
+  }
+  size_t pending() const{
+      return pendingCount;
+  }
+  // Pays everything added since the last flush; returns how many were paid.
+  // Buckets keep their capacity for the next batch.
+  size_t flush(){
+      for(Bucket& b:buckets){
+          if(!b.strategies.empty()){
+              b.strategies.front()->payBatch(b.strategies.data(),b.strategies.size());
+              b.strategies.clear();
+          }
+      }
+      size_t paid=pendingCount;
+      pendingCount=0;
+      return paid;
+  }
+};
+
+// Quiet strategies for the benchmarks: each computes a fee and keeps a
+// running total instead of printing.
+template<int FeeBps,int FlatFee>
+class FeeStub final : public BatchPayment<FeeStub<FeeBps,FlatFee>>{
+  public:
+  long long amount;
+  long long charged=0;
+  FeeStub(long long amount=0):amount(amount){}
+  void pay(){
+      // Luhn-style check over the "account number", then a tiered fee;
+      // the branches inside differ per strategy type
+      long long digits=amount*2654435761LL+FeeBps;
+      int sum=0;
+      for(int i=0;i<16;i++){
+          int d=digits%10;
+          digits/=10;
+          if(i%2==1) d=d*2>9?d*2-9:d*2;
+          sum+=d;
+      }
+      long long fee=amount*FeeBps/10000+FlatFee;
+      if(sum%10==FeeBps%10) fee-=fee/8;
+      charged+=amount+fee;
+  }
+};
+
+void benchmarkBatchCheckout(){
+    const int CHECKOUTS=1000000;
+    const int ROUNDS=20;
+    mt19937 rng(3);
+    vector<unique_ptr<PaymentStrategy>> strategies;
+    vector<Checkout> checkouts(CHECKOUTS);
+    for(int i=0;i<CHECKOUTS;i++){
+        long long amount=100+rng()%10000;
+        switch(rng()%4){
+            case 0: strategies.push_back(make_unique<FeeStub<180,0>>(amount)); break;
+            case 1: strategies.push_back(make_unique<FeeStub<0,0>>(amount)); break;
+            case 2: strategies.push_back(make_unique<FeeStub<250,30>>(amount)); break;
+            default: strategies.push_back(make_unique<FeeStub<90,5>>(amount)); break;
+        }
+        checkouts[i].setPaymentStrategy(strategies.back().get());
+    }
+    using clk=chrono::steady_clock;
+    auto t0=clk::now();
+    for(int r=0;r<ROUNDS;r++){
+        for(Checkout& c:checkouts) c.proceedToPay();
+    }
+    double single=chrono::duration<double>(clk::now()-t0).count();
+
+    long long total=CHECKOUTS*(long long)ROUNDS;
+    cout<<"4 strategy types, "<<CHECKOUTS<<" checkouts in random order, "<<ROUNDS<<" rounds"<<endl;
+    cout<<"  one at a time:        "<<(long long)(total/single)<<" payments/s"<<endl;
+
+    // Pending checkouts are flushed every `batchSize` arrivals
+    for(size_t batchSize:{(size_t)64,(size_t)1024,(size_t)16384,(size_t)CHECKOUTS}){
+        BatchCheckout batch;
+        auto t1=clk::now();
+        for(int r=0;r<ROUNDS;r++){
+            for(Checkout& c:checkouts){
+                batch.add(&c);
+                if(batch.pending()==batchSize) batch.flush();
+            }
+            batch.flush();
+        }
+        double batched=chrono::duration<double>(clk::now()-t1).count();
+        cout<<"  batched, flush @"<<setw(7)<<batchSize<<" "<<(long long)(total/batched)<<" payments/s"<<endl;
+    }
+}
+
+// Same four fee stubs as above: heap strategy + virtual pay() versus the
+// strategy stored inline in a VariantCheckout.
+void benchmarkVariantCheckout(){
+    const int CHECKOUTS=1000000;
+    const int ROUNDS=20;
+    typedef FeeStub<180,0> Card;
+    typedef FeeStub<0,0> Upi;
+    typedef FeeStub<250,30> Wallet;
+    typedef FeeStub<90,5> NetBanking;
+    mt19937 rng(3);
+    vector<unique_ptr<PaymentStrategy>> strategies;
+    vector<Checkout> open(CHECKOUTS);
+    vector<VariantCheckout<Card,Upi,Wallet,NetBanking>> closed(CHECKOUTS);
+    for(int i=0;i<CHECKOUTS;i++){
+        long long amount=100+rng()%10000;
+        switch(rng()%4){
+            case 0: strategies.push_back(make_unique<Card>(amount)); closed[i].setPaymentStrategy(Card(amount)); break;
+            case 1: strategies.push_back(make_unique<Upi>(amount)); closed[i].setPaymentStrategy(Upi(amount)); break;
+            case 2: strategies.push_back(make_unique<Wallet>(amount)); closed[i].setPaymentStrategy(Wallet(amount)); break;
+            default: strategies.push_back(make_unique<NetBanking>(amount)); closed[i].setPaymentStrategy(NetBanking(amount)); break;
+        }
+        open[i].setPaymentStrategy(strategies.back().get());
+    }
+    using clk=chrono::steady_clock;
+    auto t0=clk::now();
+    for(int r=0;r<ROUNDS;r++){
+        for(Checkout& c:open) c.proceedToPay();
+    }
+    double virtualSecs=chrono::duration<double>(clk::now()-t0).count();
+    auto t1=clk::now();
+    for(int r=0;r<ROUNDS;r++){
+        for(auto& c:closed) c.proceedToPay();
+    }
+    double variantSecs=chrono::duration<double>(clk::now()-t1).count();
+    long long total=CHECKOUTS*(long long)ROUNDS;
+    cout<<"open vs closed strategy dispatch, "<<CHECKOUTS<<" checkouts, "<<ROUNDS<<" rounds"<<endl;
+    cout<<"  virtual PaymentStrategy*: "<<(long long)(total/virtualSecs)<<" payments/s, "
+        <<sizeof(Checkout)<<" B checkout + "<<sizeof(Card)<<" B heap strategy"<<endl;
+    cout<<"  std::variant + visit:     "<<(long long)(total/variantSecs)<<" payments/s, "
+        <<sizeof(VariantCheckout<Card,Upi,Wallet,NetBanking>)<<" B checkout, no heap"<<endl;
+    cout<<"  ClosedCheckout<CreditCard,Upi>: "<<sizeof(ClosedCheckout)<<" B"<<endl;
+}
+
+// Shared state for one async benchmark run.
+struct AsyncRun{
+    AsyncCheckout* checkout;
+    size_t total;
+    atomic<size_t> next{0};
+    atomic<size_t> failures{0};
+    vector<double> latencyMs;
+};
+
+// One of `concurrency` workers: pays one checkout at a time until the run
+// is done, so the number of workers is the number of payments in flight.
+Task<bool> paymentWorker(EventLoop& loop,AsyncRun* run){
+    while(true){
+        size_t i=run->next++;
+        if(i>=run->total) break;
+        auto start=chrono::steady_clock::now();
+        if(!co_await run->checkout->proceedToPayAsync(loop)) run->failures++;
+        run->latencyMs[i]=chrono::duration<double,milli>(chrono::steady_clock::now()-start).count();
+    }
+    co_return true;
+}
+
+void benchmarkAsyncCheckout(){
+    // 5ms typical gateway latency, 1% of calls take an extra 40ms
+    StubGateway gateway(chrono::microseconds(5000),chrono::microseconds(40000),0.01);
+    AsyncCreditCardPayment card(gateway);
+    AsyncCheckout checkout;
+    checkout.setPaymentStrategy(&card);
+    const int LOOPS=2;
+
+    cout<<"in-flight  payments   payments/s   p50(ms)  p99(ms)"<<endl;
+    for(size_t concurrency:{1,10,100,1000,10000}){
+        AsyncRun run;
+        run.checkout=&checkout;
+        run.total=max<size_t>(200,concurrency*10);
+        run.latencyMs.assign(run.total,0);
+        vector<EventLoop> loops(LOOPS);
+        auto start=chrono::steady_clock::now();
+        for(size_t w=0;w<concurrency;w++){
+            EventLoop& loop=loops[w%LOOPS];
+            loop.spawn(paymentWorker(loop,&run));
+        }
+        for(EventLoop& loop:loops) loop.stop();
+        vector<thread> threads;
+        for(EventLoop& loop:loops) threads.emplace_back([&loop]{ loop.run(); });
+        for(thread& t:threads) t.join();
+        double secs=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+        sort(run.latencyMs.begin(),run.latencyMs.end());
+        printf("%9zu %9zu %12.0f %9.2f %8.2f\n",concurrency,run.total,run.total/secs,
+               run.latencyMs[run.total/2],run.latencyMs[run.total*99/100]);
+    }
+    cout<<"("<<LOOPS<<" event loop threads; a blocking checkout with the same gateway manages ~200 payments/s per thread)"<<endl;
+}
+
+// Fixed strategy choice for comparison: cycles through the strategies.
+class RoundRobinPayment : public AsyncPaymentStrategy{
+  vector<AsyncPaymentStrategy*> strategies;
+  atomic<size_t> next{0};
+  public:
+  RoundRobinPayment(vector<AsyncPaymentStrategy*> strategies):strategies(strategies){}
+  Task<bool> payAsync(EventLoop& loop) override{
+      return strategies[next++%strategies.size()]->payAsync(loop);
+  }
+};
+
+// Three stub gateways of differing quality: hand-picked, round-robin and
+// adaptive routing, at the same load.
+void benchmarkAdaptiveRouting(){
+    StubGateway steadyGw(chrono::microseconds(4000),chrono::microseconds(40000),0.05);
+    StubGateway fastGw(chrono::microseconds(2000),chrono::microseconds(30000),0.005);
+    StubGateway flakyGw(chrono::microseconds(1000),chrono::microseconds(0),0,0.3);
+    AsyncCreditCardPayment steady(steadyGw),fast(fastGw);
+    AsyncUpiPayment flaky(flakyGw);
+    RoundRobinPayment roundRobin({&steady,&fast,&flaky});
+    AdaptivePaymentRouter router;
+    router.addRoute("steady",&steady);
+    router.addRoute("fast",&fast);
+    router.addRoute("flaky",&flaky);
+
+    auto simulate=[](const char* label,AsyncPaymentStrategy* strategy){
+        AsyncCheckout checkout;
+        checkout.setPaymentStrategy(strategy);
+        AsyncRun run;
+        run.checkout=&checkout;
+        run.total=20000;
+        run.latencyMs.assign(run.total,0);
+        EventLoop loop;
+        for(int w=0;w<500;w++) loop.spawn(paymentWorker(loop,&run));
+        loop.stop();
+        loop.run();
+        sort(run.latencyMs.begin(),run.latencyMs.end());
+        printf("  %-22s p50=%6.2fms p99=%6.2fms p99.9=%6.2fms failed=%5.2f%%\n",label,run.latencyMs[run.total/2],
+               run.latencyMs[run.total*99/100],run.latencyMs[run.total*999/1000],100.0*run.failures/run.total);
+    };
+    cout<<"steady: 4ms, 5% +40ms | fast: 2ms, 0.5% +30ms | flaky: 1ms, 30% failures"<<endl;
+    simulate("by hand (steady)",&steady);
+    simulate("round-robin",&roundRobin);
+    simulate("adaptive router",&router);
+    router.printMetrics();
+}
+
+Task<bool> payAndReport(EventLoop& loop,AsyncCheckout* checkout,string label){
+    bool ok=co_await checkout->proceedToPayAsync(loop);
+    cout<<label<<(ok?" paid":" failed")<<" asynchronously"<<endl;
+    co_return ok;
+}
+
+int main(int argc,char** argv)
 {
     PaymentStrategy* strategy=new UpiPayment();
     Checkout* c=new Checkout();
     c->setPaymentStrategy(strategy);
     c->proceedToPay();
-    
+
+    // Pay several checkouts together, grouped by strategy type
+    PaymentStrategy* card=new CreditCardPayment();
+    Checkout orders[4];
+    orders[0].setPaymentStrategy(card);
+    orders[1].setPaymentStrategy(strategy);
+    orders[2].setPaymentStrategy(card);
+    orders[3].setPaymentStrategy(strategy);
+    BatchCheckout batch;
+    for(Checkout& order:orders) batch.add(&order);
+    batch.flush();
+
+    // Strategy chosen from a fixed set, stored inline
+    ClosedCheckout closed;
+    closed.setPaymentStrategy(CreditCardPayment());
+    closed.proceedToPay();
+    try{
+        ClosedCheckout unset;
+        unset.proceedToPay();
+    }
+    catch(const logic_error& e){
+        cout<<e.what()<<endl;
+    }
+
+    // Two payments in flight on one event loop thread
+    StubGateway gateway(chrono::microseconds(2000),chrono::microseconds(0),0);
+    AsyncCreditCardPayment asyncCard(gateway);
+    AsyncUpiPayment asyncUpi(gateway);
+    AsyncCheckout first,second;
+    first.setPaymentStrategy(&asyncCard);
+    second.setPaymentStrategy(&asyncUpi);
+    EventLoop loop;
+    loop.spawn(payAndReport(loop,&first,"card checkout"));
+    loop.spawn(payAndReport(loop,&second,"upi checkout"));
+    loop.stop();
+    loop.run();
+
+    // Run "./strategy_pattern bench" for the checkout benchmarks
+    if(argc>1 && string(argv[1])=="bench"){
+        benchmarkBatchCheckout();
+        benchmarkVariantCheckout();
+        benchmarkAsyncCheckout();
+        benchmarkAdaptiveRouting();
+    }
 }